@@ -0,0 +1,173 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "ChordTable.h"
+#include <algorithm>
+#include <array>
+#include <limits>
+
+// Tempo-synced arpeggiator run on the audio thread. It steps through the notes of the
+// current chord (spread over 1-4 octaves, in the chosen pattern) at a fixed number of
+// steps per beat, and writes each step's note-on, and the note-off gate * step later,
+// into the block's MIDI at the exact sample they fall on. Step times are kept in
+// fractional samples so long runs don't drift off the tempo grid. Notes arriving while
+// it is idle restart the grid where they land; later changes take over at the next step.
+// Nothing here allocates or locks - the owner serialises every call.
+class Arpeggiator
+{
+public:
+    enum class Pattern { up, down, upDown, asPlayed };
+
+    static constexpr int kMaxOctaves = 4;
+    static constexpr int kMaxSteps = 2 * ChordTable::kMaxNotes * kMaxOctaves;
+
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        updateStepLength();
+    }
+
+    void setTempo(double beatsPerMinute) { bpm = juce::jlimit(20.0, 400.0, beatsPerMinute); updateStepLength(); }
+    void setStepsPerBeat(double steps)   { stepsPerBeat = juce::jlimit(0.25, 16.0, steps); updateStepLength(); } // 2 = eighths, 3 = eighth triplets
+    void setGate(float fractionOfStep)   { gate = juce::jlimit(0.05f, 1.0f, fractionOfStep); }
+    void setPattern(Pattern newPattern)  { pattern = newPattern; buildSequence(); }
+    void setOctaves(int numOctaves)      { octaves = juce::jlimit(1, kMaxOctaves, numOctaves); buildSequence(); }
+    void setChannel(int midiChannel)     { channel = juce::jlimit(1, 16, midiChannel); }
+
+    void setNotes(const ChordTable::Chord& newChord, float newVelocity)
+    {
+        const bool wasIdle = ! isRunning();
+        chord = newChord;
+        velocity = newVelocity;
+        buildSequence();
+
+        if (wasIdle)
+        {
+            step = 0;
+            nextStep = 0.0;
+        }
+    }
+
+    // The sounding note is stopped at the start of the next block
+    void clearNotes() { chord = {}; numSteps = 0; }
+
+    // Has notes to play, or one still to stop
+    bool isRunning() const noexcept { return numSteps > 0 || soundingNote >= 0; }
+
+    // Adds this block's steps to midi (block-relative times from startSample)
+    void process(juce::MidiBuffer& midi, int startSample, int numSamples)
+    {
+        if (numSteps == 0)
+        {
+            if (soundingNote >= 0)
+                stopSoundingNote(midi, startSample);
+            return;
+        }
+
+        for (;;)
+        {
+            const double event = juce::jmin(nextNoteOff, nextStep);
+            if (event >= numSamples)
+                break;
+
+            const int position = startSample + juce::jmax(0, static_cast<int>(event));
+
+            if (nextNoteOff <= nextStep)
+            {
+                stopSoundingNote(midi, position);
+                continue;
+            }
+
+            if (soundingNote >= 0)
+                stopSoundingNote(midi, position);
+
+            step %= numSteps;
+            soundingNote = sequence[static_cast<size_t>(step)];
+            midi.addEvent(juce::MidiMessage::noteOn(channel, soundingNote, velocity), position);
+            nextNoteOff = nextStep + gate * stepLength;
+
+            step = (step + 1) % numSteps;
+            nextStep += stepLength;
+        }
+
+        nextStep -= numSamples;
+        if (soundingNote >= 0)
+            nextNoteOff -= numSamples;
+    }
+
+private:
+    static constexpr double never = std::numeric_limits<double>::max();
+
+    void stopSoundingNote(juce::MidiBuffer& midi, int position)
+    {
+        midi.addEvent(juce::MidiMessage::noteOff(channel, soundingNote), position);
+        soundingNote = -1;
+        nextNoteOff = never;
+    }
+
+    void updateStepLength()
+    {
+        stepLength = juce::jmax(1.0, sampleRate * 60.0 / (bpm * stepsPerBeat));
+    }
+
+    void buildSequence()
+    {
+        numSteps = 0;
+        auto add = [this](int note) { if (note <= 127) sequence[static_cast<size_t>(numSteps++)] = note; };
+
+        // The chord's notes in the order given (asPlayed) or lowest first, octave by octave
+        auto order = chord.notes;
+        if (pattern != Pattern::asPlayed)
+            std::sort(order.begin(), order.begin() + chord.numNotes);
+
+        auto spread = [&]
+        {
+            for (int octave = 0; octave < octaves; ++octave)
+                for (int i = 0; i < chord.numNotes; ++i)
+                    add(order[static_cast<size_t>(i)] + 12 * octave);
+        };
+
+        switch (pattern)
+        {
+            case Pattern::up:
+            case Pattern::asPlayed:
+                spread();
+                break;
+
+            case Pattern::down:
+                spread();
+                std::reverse(sequence.begin(), sequence.begin() + numSteps);
+                break;
+
+            case Pattern::upDown:
+            {
+                // Up, then back down without repeating the top and bottom notes
+                spread();
+                const int top = numSteps;
+                for (int i = top - 2; i > 0; --i)
+                    sequence[static_cast<size_t>(numSteps++)] = sequence[static_cast<size_t>(i)];
+                break;
+            }
+        }
+    }
+
+    double sampleRate = 44100.0;
+    double bpm = 120.0;
+    double stepsPerBeat = 2.0;
+    double stepLength = 11025.0;
+    float gate = 0.5f;
+    Pattern pattern = Pattern::up;
+    int octaves = 1;
+    int channel = 1;
+
+    ChordTable::Chord chord;
+    float velocity = 1.0f;
+    std::array<int, kMaxSteps> sequence {};
+    int numSteps = 0;
+
+    // Audio-thread position, in samples from the start of the next block
+    int step = 0;
+    double nextStep = 0.0;
+    double nextNoteOff = never;
+    int soundingNote = -1;
+};
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// Chord shapes as compile-time interval tables. build() spells a chord from a root, a
+// quality and an inversion into a fixed-size Chord - no allocation, and usable in
+// constant expressions.
+class ChordTable
+{
+public:
+    static constexpr int kMaxNotes = 5; // up to ninth chords
+
+    enum class Quality
+    {
+        major,
+        minor,
+        diminished,
+        augmented,
+        sus2,
+        sus4,
+        major6,
+        minor6,
+        dominant7,
+        major7,
+        minor7,
+        minorMajor7,
+        halfDiminished7,
+        diminished7,
+        augmented7,
+        add9,
+        dominant9,
+        major9,
+        minor9,
+        numQualities
+    };
+
+    struct Shape
+    {
+        const char* name;
+        int numNotes;
+        std::array<int8_t, kMaxNotes> intervals; // semitones above the root, ascending
+    };
+
+    static constexpr int kNumQualities = static_cast<int>(Quality::numQualities);
+
+    static constexpr std::array<Shape, kNumQualities> shapes {{
+        { "maj",     3, { 0, 4, 7 } },
+        { "min",     3, { 0, 3, 7 } },
+        { "dim",     3, { 0, 3, 6 } },
+        { "aug",     3, { 0, 4, 8 } },
+        { "sus2",    3, { 0, 2, 7 } },
+        { "sus4",    3, { 0, 5, 7 } },
+        { "6",       4, { 0, 4, 7, 9 } },
+        { "m6",      4, { 0, 3, 7, 9 } },
+        { "7",       4, { 0, 4, 7, 10 } },
+        { "maj7",    4, { 0, 4, 7, 11 } },
+        { "m7",      4, { 0, 3, 7, 10 } },
+        { "m(maj7)", 4, { 0, 3, 7, 11 } },
+        { "m7b5",    4, { 0, 3, 6, 10 } },
+        { "dim7",    4, { 0, 3, 6, 9 } },
+        { "aug7",    4, { 0, 4, 8, 10 } },
+        { "add9",    4, { 0, 4, 7, 14 } },
+        { "9",       5, { 0, 4, 7, 10, 14 } },
+        { "maj9",    5, { 0, 4, 7, 11, 14 } },
+        { "m9",      5, { 0, 3, 7, 10, 14 } }
+    }};
+
+    // MIDI notes - lowest first when spelled by build()
+    struct Chord
+    {
+        std::array<int, kMaxNotes> notes {};
+        int numNotes = 0;
+    };
+
+    static constexpr const Shape& getShape(Quality quality) noexcept
+    {
+        return shapes[static_cast<size_t>(quality)];
+    }
+
+    // Inversion n lifts the lowest n chord tones an octave (0 = root position, taken
+    // modulo the number of notes). Notes outside 0..127 are left out.
+    static constexpr Chord build(int rootNote, Quality quality, int inversion = 0) noexcept
+    {
+        const auto& shape = getShape(quality);
+        const int lifted = ((inversion % shape.numNotes) + shape.numNotes) % shape.numNotes;
+
+        std::array<int, kMaxNotes> voiced {};
+        for (int i = 0; i < shape.numNotes; ++i)
+            voiced[static_cast<size_t>(i)] = rootNote + shape.intervals[static_cast<size_t>(i)] + (i < lifted ? 12 : 0);
+
+        // Insertion sort - a lifted root can land above a ninth
+        for (int i = 1; i < shape.numNotes; ++i)
+            for (int j = i; j > 0 && voiced[static_cast<size_t>(j - 1)] > voiced[static_cast<size_t>(j)]; --j)
+            {
+                const int swapped = voiced[static_cast<size_t>(j)];
+                voiced[static_cast<size_t>(j)] = voiced[static_cast<size_t>(j - 1)];
+                voiced[static_cast<size_t>(j - 1)] = swapped;
+            }
+
+        Chord chord;
+        for (int i = 0; i < shape.numNotes; ++i)
+            if (voiced[static_cast<size_t>(i)] >= 0 && voiced[static_cast<size_t>(i)] <= 127)
+                chord.notes[static_cast<size_t>(chord.numNotes++)] = voiced[static_cast<size_t>(i)];
+
+        return chord;
+    }
+};
+
+static_assert(ChordTable::build(60, ChordTable::Quality::major).notes[2] == 67, "root position");
+static_assert(ChordTable::build(60, ChordTable::Quality::major, 1).notes[0] == 64, "first inversion");
+static_assert(ChordTable::build(60, ChordTable::Quality::dominant9, 1).notes[3] == 72, "lifted root sorts below the ninth");
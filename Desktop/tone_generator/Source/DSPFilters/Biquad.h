@@ -0,0 +1,101 @@
+#pragma once
+#include <array>
+#include <complex>
+
+namespace Dsp {
+
+    // One second-order section: H(z) = (b0 + b1 z^-1 + b2 z^-2) / (1 + a1 z^-1 + a2 z^-2)
+    struct Biquad {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0;
+        double a1 = 0.0, a2 = 0.0;
+
+        // Complex response at normalised angular frequency w (radians per sample)
+        std::complex<double> response(double w) const {
+            const std::complex<double> z1 = std::polar(1.0, -w);
+            const std::complex<double> z2 = z1 * z1;
+            return (b0 + b1 * z1 + b2 * z2) / (1.0 + a1 * z1 + a2 * z2);
+        }
+    };
+
+    // Cascade of second-order sections, transposed direct form II.
+    // Samples are processed a chunk at a time with the channels interleaved
+    // so the innermost loop runs across channels in lock-step (one SIMD lane
+    // per channel); coefficients only change through setSections().
+    template<int MaxSections, int Channels>
+    class Cascade {
+    public:
+        static constexpr int kChunkSize = 64;
+
+        void setSections(const Biquad* sections, int count) {
+            numSections_ = count < 0 ? 0 : (count > MaxSections ? MaxSections : count);
+            for (int s = 0; s < numSections_; ++s) {
+                auto& c = coefficients_[static_cast<size_t>(s)];
+                c.b0 = static_cast<float>(sections[s].b0);
+                c.b1 = static_cast<float>(sections[s].b1);
+                c.b2 = static_cast<float>(sections[s].b2);
+                c.a1 = static_cast<float>(sections[s].a1);
+                c.a2 = static_cast<float>(sections[s].a2);
+            }
+        }
+
+        int getNumSections() const { return numSections_; }
+
+        void reset() {
+            for (auto& section : state_)
+                section = {};
+        }
+
+        void process(int numSamples, float* const* channels) {
+            float frame[kChunkSize][Channels];
+
+            for (int start = 0; start < numSamples; start += kChunkSize) {
+                const int count = numSamples - start < kChunkSize ? numSamples - start : kChunkSize;
+
+                // Interleave
+                for (int ch = 0; ch < Channels; ++ch) {
+                    const float* src = channels[ch];
+                    for (int i = 0; i < count; ++i)
+                        frame[i][ch] = src != nullptr ? src[start + i] : 0.0f;
+                }
+
+                for (int s = 0; s < numSections_; ++s) {
+                    const auto& c = coefficients_[static_cast<size_t>(s)];
+                    auto& st = state_[static_cast<size_t>(s)];
+
+                    for (int i = 0; i < count; ++i) {
+                        for (int ch = 0; ch < Channels; ++ch) {
+                            const float x = frame[i][ch];
+                            const float y = c.b0 * x + st.z1[ch];
+                            st.z1[ch] = c.b1 * x - c.a1 * y + st.z2[ch];
+                            st.z2[ch] = c.b2 * x - c.a2 * y;
+                            frame[i][ch] = y;
+                        }
+                    }
+                }
+
+                // De-interleave
+                for (int ch = 0; ch < Channels; ++ch) {
+                    float* dest = channels[ch];
+                    if (dest == nullptr)
+                        continue;
+                    for (int i = 0; i < count; ++i)
+                        dest[start + i] = frame[i][ch];
+                }
+            }
+        }
+
+    private:
+        struct Coefficients {
+            float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+        };
+
+        struct State {
+            float z1[Channels] = {};
+            float z2[Channels] = {};
+        };
+
+        std::array<Coefficients, MaxSections> coefficients_ {};
+        std::array<State, MaxSections> state_ {};
+        int numSections_ = 0;
+    };
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include "Design.h"
+
+// Butterworth: maximally flat passband, -3 dB at the cutoff
+// Params: 0 sample rate, 1 order, 2 cutoff (band-pass: centre), 3 band-pass bandwidth in Hz
+namespace Dsp {
+    namespace Butterworth {
+        namespace Design {
+
+            template<int MaxOrder>
+            struct LowPass {
+                static constexpr int MaxSections = (MaxOrder + 1) / 2;
+
+                static void setDefaults(ParamArray&) {}
+
+                static int design(const ParamArray& params, Biquad* sections) {
+                    AnalogPrototype proto;
+                    Prototype::butterworth(clampOrder(params[idOrder], MaxOrder), proto);
+                    return Dsp::design(proto, Response::lowPass, params, 0.0, 1.0, sections, MaxSections);
+                }
+            };
+
+            template<int MaxOrder>
+            struct HighPass {
+                static constexpr int MaxSections = (MaxOrder + 1) / 2;
+
+                static void setDefaults(ParamArray&) {}
+
+                static int design(const ParamArray& params, Biquad* sections) {
+                    AnalogPrototype proto;
+                    Prototype::butterworth(clampOrder(params[idOrder], MaxOrder), proto);
+                    return Dsp::design(proto, Response::highPass, params, 0.0, 1.0, sections, MaxSections);
+                }
+            };
+
+            template<int MaxOrder>
+            struct BandPass {
+                static constexpr int MaxSections = MaxOrder;
+
+                static void setDefaults(ParamArray& params) { params[3] = 200.0; }
+
+                static int design(const ParamArray& params, Biquad* sections) {
+                    AnalogPrototype proto;
+                    Prototype::butterworth(clampOrder(params[idOrder], MaxOrder), proto);
+                    return Dsp::design(proto, Response::bandPass, params, params[3], 1.0, sections, MaxSections);
+                }
+            };
+        }
+    }
+}
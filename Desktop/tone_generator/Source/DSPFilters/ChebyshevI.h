@@ -0,0 +1,67 @@
+#pragma once
+#include "Design.h"
+
+// Chebyshev type I: equiripple passband, steeper roll-off than Butterworth
+// Params: 0 sample rate, 1 order, 2 cutoff, 3 passband ripple dB
+// Band-pass: 0 sample rate, 1 order, 2 centre, 3 bandwidth Hz, 4 passband ripple dB
+namespace Dsp {
+    namespace ChebyshevI {
+
+        // Even orders start the passband at the bottom of the ripple
+        inline double passbandGain(int order, double rippleDb) {
+            return (order % 2 == 0) ? std::pow(10.0, -rippleDb / 20.0) : 1.0;
+        }
+
+        inline double clampRipple(double rippleDb) {
+            return std::fmin(std::fmax(rippleDb, 0.01), 12.0);
+        }
+
+        namespace Design {
+
+            template<int MaxOrder>
+            struct LowPass {
+                static constexpr int MaxSections = (MaxOrder + 1) / 2;
+
+                static void setDefaults(ParamArray& params) { params[3] = 1.0; }
+
+                static int design(const ParamArray& params, Biquad* sections) {
+                    const int order = clampOrder(params[idOrder], MaxOrder);
+                    const double ripple = clampRipple(params[3]);
+                    AnalogPrototype proto;
+                    Prototype::chebyshevI(order, ripple, proto);
+                    return Dsp::design(proto, Response::lowPass, params, 0.0, passbandGain(order, ripple), sections, MaxSections);
+                }
+            };
+
+            template<int MaxOrder>
+            struct HighPass {
+                static constexpr int MaxSections = (MaxOrder + 1) / 2;
+
+                static void setDefaults(ParamArray& params) { params[3] = 1.0; }
+
+                static int design(const ParamArray& params, Biquad* sections) {
+                    const int order = clampOrder(params[idOrder], MaxOrder);
+                    const double ripple = clampRipple(params[3]);
+                    AnalogPrototype proto;
+                    Prototype::chebyshevI(order, ripple, proto);
+                    return Dsp::design(proto, Response::highPass, params, 0.0, passbandGain(order, ripple), sections, MaxSections);
+                }
+            };
+
+            template<int MaxOrder>
+            struct BandPass {
+                static constexpr int MaxSections = MaxOrder;
+
+                static void setDefaults(ParamArray& params) { params[3] = 200.0; params[4] = 1.0; }
+
+                static int design(const ParamArray& params, Biquad* sections) {
+                    const int order = clampOrder(params[idOrder], MaxOrder);
+                    const double ripple = clampRipple(params[4]);
+                    AnalogPrototype proto;
+                    Prototype::chebyshevI(order, ripple, proto);
+                    return Dsp::design(proto, Response::bandPass, params, params[3], passbandGain(order, ripple), sections, MaxSections);
+                }
+            };
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "Design.h"
+
+// Chebyshev type II (inverse): flat passband, equiripple stop band.
+// The frequency parameter is where the stop band begins.
+// Params: 0 sample rate, 1 order, 2 stop band edge, 3 stop band attenuation dB
+// Band-pass: 0 sample rate, 1 order, 2 centre, 3 bandwidth Hz, 4 stop band attenuation dB
+namespace Dsp {
+    namespace ChebyshevII {
+
+        inline double clampStopBand(double stopBandDb) {
+            return std::fmin(std::fmax(stopBandDb, 3.0), 120.0);
+        }
+
+        namespace Design {
+
+            template<int MaxOrder>
+            struct LowPass {
+                static constexpr int MaxSections = (MaxOrder + 1) / 2;
+
+                static void setDefaults(ParamArray& params) { params[3] = 48.0; }
+
+                static int design(const ParamArray& params, Biquad* sections) {
+                    AnalogPrototype proto;
+                    Prototype::chebyshevII(clampOrder(params[idOrder], MaxOrder), clampStopBand(params[3]), proto);
+                    return Dsp::design(proto, Response::lowPass, params, 0.0, 1.0, sections, MaxSections);
+                }
+            };
+
+            template<int MaxOrder>
+            struct HighPass {
+                static constexpr int MaxSections = (MaxOrder + 1) / 2;
+
+                static void setDefaults(ParamArray& params) { params[3] = 48.0; }
+
+                static int design(const ParamArray& params, Biquad* sections) {
+                    AnalogPrototype proto;
+                    Prototype::chebyshevII(clampOrder(params[idOrder], MaxOrder), clampStopBand(params[3]), proto);
+                    return Dsp::design(proto, Response::highPass, params, 0.0, 1.0, sections, MaxSections);
+                }
+            };
+
+            template<int MaxOrder>
+            struct BandPass {
+                static constexpr int MaxSections = MaxOrder;
+
+                static void setDefaults(ParamArray& params) { params[3] = 200.0; params[4] = 48.0; }
+
+                static int design(const ParamArray& params, Biquad* sections) {
+                    AnalogPrototype proto;
+                    Prototype::chebyshevII(clampOrder(params[idOrder], MaxOrder), clampStopBand(params[4]), proto);
+                    return Dsp::design(proto, Response::bandPass, params, params[3], 1.0, sections, MaxSections);
+                }
+            };
+        }
+    }
+}
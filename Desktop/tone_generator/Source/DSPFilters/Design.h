@@ -0,0 +1,262 @@
+#pragma once
+#include <array>
+#include <cmath>
+#include <complex>
+#include <utility>
+#include "Biquad.h"
+
+// Analog prototype -> s-plane transform -> bilinear transform -> second-order sections.
+// Everything here runs when parameters change, never in the audio loop.
+namespace Dsp {
+
+    typedef std::complex<double> complex_t;
+
+    constexpr double kPi = 3.14159265358979323846;
+
+    // Parameter slots shared by every design (same layout as the DSPFilters library):
+    // 0 sample rate, 1 order, 2 cutoff/centre frequency, 3+ design specific
+    // (band-pass: 3 = bandwidth in Hz; Chebyshev ripple/stop band dB follows in the next slot)
+    enum ParamId {
+        idSampleRate = 0,
+        idOrder = 1,
+        idFrequency = 2,
+        kMaxParams = 8
+    };
+
+    typedef std::array<double, kMaxParams> ParamArray;
+
+    enum class Response { lowPass, highPass, bandPass };
+
+    // Normalised (1 rad/s) analog prototype. Zeros past numZeros are at infinity.
+    struct AnalogPrototype {
+        static constexpr int kMaxPoles = 16;
+        complex_t poles[kMaxPoles];
+        complex_t zeros[kMaxPoles];
+        int numPoles = 0;
+        int numZeros = 0;
+    };
+
+    namespace Prototype {
+
+        inline void butterworth(int order, AnalogPrototype& proto) {
+            proto.numPoles = order;
+            proto.numZeros = 0;
+            for (int k = 0; k < order; ++k)
+                proto.poles[k] = std::polar(1.0, kPi * (2.0 * k + order + 1.0) / (2.0 * order));
+        }
+
+        inline void chebyshevI(int order, double rippleDb, AnalogPrototype& proto) {
+            const double eps = std::sqrt(std::pow(10.0, rippleDb / 10.0) - 1.0);
+            const double mu = std::asinh(1.0 / eps) / order;
+            proto.numPoles = order;
+            proto.numZeros = 0;
+            for (int k = 0; k < order; ++k) {
+                const double theta = kPi * (2.0 * k + 1.0) / (2.0 * order);
+                proto.poles[k] = complex_t(-std::sinh(mu) * std::sin(theta), std::cosh(mu) * std::cos(theta));
+            }
+        }
+
+        // Inverse Chebyshev: flat passband, equiripple stop band starting at 1 rad/s
+        inline void chebyshevII(int order, double stopBandDb, AnalogPrototype& proto) {
+            const double eps = 1.0 / std::sqrt(std::pow(10.0, stopBandDb / 10.0) - 1.0);
+            const double mu = std::asinh(1.0 / eps) / order;
+            proto.numPoles = order;
+            proto.numZeros = 0;
+            for (int k = 0; k < order; ++k) {
+                const double theta = kPi * (2.0 * k + 1.0) / (2.0 * order);
+                proto.poles[k] = 1.0 / complex_t(-std::sinh(mu) * std::sin(theta), std::cosh(mu) * std::cos(theta));
+
+                const double c = std::cos(theta);
+                if (std::abs(c) > 1e-12)
+                    proto.zeros[proto.numZeros++] = complex_t(0.0, 1.0 / c);
+            }
+        }
+
+        // Linkwitz-Riley is a squared Butterworth of half the order (order must be even)
+        inline void linkwitzRiley(int order, AnalogPrototype& proto) {
+            AnalogPrototype half;
+            butterworth(order / 2, half);
+            proto.numPoles = 0;
+            proto.numZeros = 0;
+            for (int k = 0; k < half.numPoles; ++k) {
+                proto.poles[proto.numPoles++] = half.poles[k];
+                proto.poles[proto.numPoles++] = half.poles[k];
+            }
+        }
+    }
+
+    // Digital poles/zeros after the bilinear transform (always as many zeros as poles)
+    struct DigitalLayout {
+        static constexpr int kMaxPoles = 2 * AnalogPrototype::kMaxPoles;
+        complex_t poles[kMaxPoles];
+        complex_t zeros[kMaxPoles];
+        int numPoles = 0;
+        int numZeros = 0;
+        complex_t referencePoint { 1.0, 0.0 }; // where the passband gain is normalised
+    };
+
+    namespace detail {
+
+        inline complex_t bilinear(complex_t s) {
+            return (1.0 + s) / (1.0 - s);
+        }
+
+        // Pre-warped analog frequency for a digital frequency in Hz (bilinear with k = 1)
+        inline double prewarp(double frequency, double sampleRate) {
+            const double limited = std::fmin(std::fmax(frequency, sampleRate * 1e-5), sampleRate * 0.4999);
+            return std::tan(kPi * limited / sampleRate);
+        }
+
+        // s -> (s^2 + w0^2) / (B s): each root becomes a pair
+        inline void bandPassRoots(complex_t root, double w0, double bandwidth, complex_t& first, complex_t& second) {
+            const complex_t b = root * bandwidth;
+            const complex_t d = std::sqrt(b * b - 4.0 * w0 * w0);
+            first = (b + d) * 0.5;
+            second = (b - d) * 0.5;
+        }
+
+        struct RootPair {
+            complex_t a, b;
+        };
+
+        // Groups roots into conjugate or real pairs; an odd real root is paired with the origin
+        inline int makePairs(const complex_t* roots, int count, RootPair* pairs) {
+            constexpr double kRealTolerance = 1e-9;
+            double reals[DigitalLayout::kMaxPoles];
+            int numReals = 0;
+            int numPairs = 0;
+
+            for (int i = 0; i < count; ++i) {
+                if (std::abs(roots[i].imag()) < kRealTolerance)
+                    reals[numReals++] = roots[i].real();
+                else if (roots[i].imag() > 0.0)
+                    pairs[numPairs++] = { roots[i], std::conj(roots[i]) };
+            }
+
+            // Sort the real roots, then pair outside-in so band-pass sections get one zero at each end
+            for (int i = 1; i < numReals; ++i)
+                for (int j = i; j > 0 && reals[j - 1] > reals[j]; --j)
+                    std::swap(reals[j - 1], reals[j]);
+
+            for (int lo = 0, hi = numReals - 1; lo <= hi; ++lo, --hi)
+                pairs[numPairs++] = { complex_t(reals[lo], 0.0), lo == hi ? complex_t(0.0, 0.0) : complex_t(reals[hi], 0.0) };
+
+            return numPairs;
+        }
+    }
+
+    inline void transform(const AnalogPrototype& proto, Response response, double sampleRate,
+                          double frequency, double bandwidthHz, DigitalLayout& layout) {
+        layout.numPoles = 0;
+        layout.numZeros = 0;
+        const int infiniteZeros = proto.numPoles - proto.numZeros;
+
+        if (response == Response::bandPass) {
+            const double half = bandwidthHz * 0.5;
+            const double lower = detail::prewarp(std::fmax(frequency - half, 1.0), sampleRate);
+            const double upper = detail::prewarp(frequency + half, sampleRate);
+            const double w0 = std::sqrt(lower * upper);
+            const double bw = std::fmax(upper - lower, 1e-9);
+
+            complex_t first, second;
+            for (int i = 0; i < proto.numPoles; ++i) {
+                detail::bandPassRoots(proto.poles[i], w0, bw, first, second);
+                layout.poles[layout.numPoles++] = detail::bilinear(first);
+                layout.poles[layout.numPoles++] = detail::bilinear(second);
+            }
+            for (int i = 0; i < proto.numZeros; ++i) {
+                detail::bandPassRoots(proto.zeros[i], w0, bw, first, second);
+                layout.zeros[layout.numZeros++] = detail::bilinear(first);
+                layout.zeros[layout.numZeros++] = detail::bilinear(second);
+            }
+            // Each zero at infinity becomes one at DC and one at Nyquist
+            for (int i = 0; i < infiniteZeros; ++i) {
+                layout.zeros[layout.numZeros++] = complex_t(1.0, 0.0);
+                layout.zeros[layout.numZeros++] = complex_t(-1.0, 0.0);
+            }
+            layout.referencePoint = std::polar(1.0, 2.0 * std::atan(w0));
+            return;
+        }
+
+        const double w = detail::prewarp(frequency, sampleRate);
+        const bool lowPass = response == Response::lowPass;
+
+        for (int i = 0; i < proto.numPoles; ++i)
+            layout.poles[layout.numPoles++] = detail::bilinear(lowPass ? proto.poles[i] * w : w / proto.poles[i]);
+        for (int i = 0; i < proto.numZeros; ++i)
+            layout.zeros[layout.numZeros++] = detail::bilinear(lowPass ? proto.zeros[i] * w : w / proto.zeros[i]);
+        for (int i = 0; i < infiniteZeros; ++i)
+            layout.zeros[layout.numZeros++] = complex_t(lowPass ? -1.0 : 1.0, 0.0);
+
+        layout.referencePoint = complex_t(lowPass ? 1.0 : -1.0, 0.0);
+    }
+
+    // Turns a digital layout into sections and scales them for the given passband gain.
+    // Returns the number of sections written (at most maxSections).
+    inline int layoutToSections(const DigitalLayout& layout, double passbandGain, Biquad* sections, int maxSections) {
+        detail::RootPair polePairs[DigitalLayout::kMaxPoles];
+        detail::RootPair zeroPairs[DigitalLayout::kMaxPoles];
+        bool zeroUsed[DigitalLayout::kMaxPoles] = {};
+
+        const int numPolePairs = detail::makePairs(layout.poles, layout.numPoles, polePairs);
+        const int numZeroPairs = detail::makePairs(layout.zeros, layout.numZeros, zeroPairs);
+        const int numSections = numPolePairs < maxSections ? numPolePairs : maxSections;
+
+        for (int s = 0; s < numSections; ++s) {
+            const auto& p = polePairs[s];
+            auto& section = sections[s];
+            section = Biquad();
+            section.a1 = -(p.a + p.b).real();
+            section.a2 = (p.a * p.b).real();
+
+            // Pair each pole pair with the nearest unused zero pair to keep section gains sane
+            int best = -1;
+            double bestDistance = 0.0;
+            for (int z = 0; z < numZeroPairs; ++z) {
+                if (zeroUsed[z])
+                    continue;
+                const double distance = std::abs(zeroPairs[z].a - p.a);
+                if (best < 0 || distance < bestDistance) {
+                    best = z;
+                    bestDistance = distance;
+                }
+            }
+            if (best >= 0) {
+                zeroUsed[best] = true;
+                section.b1 = -(zeroPairs[best].a + zeroPairs[best].b).real();
+                section.b2 = (zeroPairs[best].a * zeroPairs[best].b).real();
+            }
+        }
+
+        // Normalise the overall gain at the reference point, spread evenly over the sections
+        if (numSections > 0) {
+            const double w = std::arg(layout.referencePoint);
+            double gain = 1.0;
+            for (int s = 0; s < numSections; ++s)
+                gain *= std::abs(sections[s].response(w));
+
+            if (gain > 1e-30) {
+                const double scale = std::pow(passbandGain / gain, 1.0 / numSections);
+                for (int s = 0; s < numSections; ++s) {
+                    sections[s].b0 *= scale;
+                    sections[s].b1 *= scale;
+                    sections[s].b2 *= scale;
+                }
+            }
+        }
+
+        return numSections;
+    }
+
+    inline int clampOrder(double order, int maxOrder) {
+        const int rounded = static_cast<int>(std::lround(order));
+        return rounded < 1 ? 1 : (rounded > maxOrder ? maxOrder : rounded);
+    }
+
+    inline int design(const AnalogPrototype& proto, Response response, const ParamArray& params,
+                      double bandwidthHz, double passbandGain, Biquad* sections, int maxSections) {
+        DigitalLayout layout;
+        transform(proto, response, params[idSampleRate], params[idFrequency], bandwidthHz, layout);
+        return layoutToSections(layout, passbandGain, sections, maxSections);
+    }
+}
@@ -1,59 +1,84 @@
 #pragma once
 #include <vector>
+#include "Biquad.h"
+#include "Design.h"
+#include "Butterworth.h"
+#include "ChebyshevI.h"
+#include "ChebyshevII.h"
+#include "LinkwitzRiley.h"
 
 namespace Dsp {
     typedef std::vector<float> Params;
-    
+
     class Filter {
     public:
         virtual ~Filter() = default;
         virtual void setParams(const Params& params) = 0;
         virtual void setParam(int index, float value) = 0;
         virtual void process(int numSamples, float* const* channels) = 0;
+        virtual void reset() {}
     };
-    
+
+    // Runs DesignClass (e.g. Butterworth::Design::LowPass<4>) as a cascade of
+    // second-order sections over Channels channels. Coefficients are worked out
+    // in setParams/setParam only; process() just runs the sections.
     template<typename DesignClass, int Channels>
     class FilterDesign : public Filter {
     public:
-        FilterDesign() {}
-        
+        FilterDesign() {
+            params_.fill(0.0);
+            params_[idSampleRate] = 44100.0;
+            params_[idOrder] = 4.0;
+            params_[idFrequency] = 1000.0;
+            DesignClass::setDefaults(params_);
+            update();
+        }
+
         void setParams(const Params& params) override {
-            if (params.size() >= 3) {
-                sampleRate_ = params[0];
-                order_ = static_cast<int>(params[1]);
-                cutoff_ = params[2];
-            }
+            const size_t count = params.size() < params_.size() ? params.size() : params_.size();
+            for (size_t i = 0; i < count; ++i)
+                params_[i] = params[i];
+            update();
         }
-        
+
         void setParam(int index, float value) override {
-            if (index == 2) cutoff_ = value;
+            if (index < 0 || index >= kMaxParams)
+                return;
+            params_[static_cast<size_t>(index)] = value;
+            update();
         }
-        
+
         void process(int numSamples, float* const* channels) override {
-            // Simple low-pass filter approximation
-            for (int sample = 0; sample < numSamples; ++sample) {
-                for (int ch = 0; ch < Channels; ++ch) {
-                    if (channels[ch]) {
-                        float input = channels[ch][sample];
-                        float alpha = cutoff_ / (cutoff_ + sampleRate_);
-                        lastOutput_[ch] = alpha * input + (1.0f - alpha) * lastOutput_[ch];
-                        channels[ch][sample] = lastOutput_[ch];
-                    }
-                }
-            }
+            cascade_.process(numSamples, channels);
+        }
+
+        void reset() override {
+            cascade_.reset();
         }
-        
+
+        double getParam(int index) const { return params_[static_cast<size_t>(index)]; }
+        int getNumSections() const { return cascade_.getNumSections(); }
+
+        // Magnitude response at a frequency in Hz, straight from the designed sections
+        double getMagnitude(double frequency) const {
+            const double w = 2.0 * kPi * frequency / params_[idSampleRate];
+            double magnitude = 1.0;
+            for (int s = 0; s < numSections_; ++s)
+                magnitude *= std::abs(sections_[static_cast<size_t>(s)].response(w));
+            return magnitude;
+        }
+
     private:
-        float sampleRate_ = 44100.0f;
-        int order_ = 4;
-        float cutoff_ = 1000.0f;
-        float lastOutput_[Channels] = {0.0f};
-    };
-    
-    namespace Butterworth {
-        namespace Design {
-            template<int Order>
-            class LowPass {};
+        void update() {
+            if (params_[idSampleRate] <= 0.0)
+                return;
+            numSections_ = DesignClass::design(params_, sections_.data());
+            cascade_.setSections(sections_.data(), numSections_);
         }
-    }
+
+        ParamArray params_;
+        std::array<Biquad, DesignClass::MaxSections> sections_ {};
+        int numSections_ = 0;
+        Cascade<DesignClass::MaxSections, Channels> cascade_;
+    };
 }
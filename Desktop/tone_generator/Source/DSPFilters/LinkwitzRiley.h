@@ -0,0 +1,61 @@
+#pragma once
+#include "Design.h"
+
+// Linkwitz-Riley: squared Butterworth, -6 dB at the cutoff so matching
+// low/high-pass pairs sum flat. Orders are even (2, 4, 6, 8); odd values round up.
+// Params: 0 sample rate, 1 order, 2 cutoff (band-pass: centre), 3 band-pass bandwidth in Hz
+namespace Dsp {
+    namespace LinkwitzRiley {
+
+        inline int evenOrder(double order, int maxOrder) {
+            const int clamped = clampOrder(order, maxOrder);
+            const int even = clamped + (clamped % 2);
+            return even > maxOrder ? maxOrder - (maxOrder % 2) : even;
+        }
+
+        namespace Design {
+
+            template<int MaxOrder>
+            struct LowPass {
+                static_assert(MaxOrder >= 2, "Linkwitz-Riley needs at least 2nd order");
+                static constexpr int MaxSections = MaxOrder / 2;
+
+                static void setDefaults(ParamArray&) {}
+
+                static int design(const ParamArray& params, Biquad* sections) {
+                    AnalogPrototype proto;
+                    Prototype::linkwitzRiley(evenOrder(params[idOrder], MaxOrder), proto);
+                    return Dsp::design(proto, Response::lowPass, params, 0.0, 1.0, sections, MaxSections);
+                }
+            };
+
+            template<int MaxOrder>
+            struct HighPass {
+                static_assert(MaxOrder >= 2, "Linkwitz-Riley needs at least 2nd order");
+                static constexpr int MaxSections = MaxOrder / 2;
+
+                static void setDefaults(ParamArray&) {}
+
+                static int design(const ParamArray& params, Biquad* sections) {
+                    AnalogPrototype proto;
+                    Prototype::linkwitzRiley(evenOrder(params[idOrder], MaxOrder), proto);
+                    return Dsp::design(proto, Response::highPass, params, 0.0, 1.0, sections, MaxSections);
+                }
+            };
+
+            template<int MaxOrder>
+            struct BandPass {
+                static_assert(MaxOrder >= 2, "Linkwitz-Riley needs at least 2nd order");
+                static constexpr int MaxSections = MaxOrder;
+
+                static void setDefaults(ParamArray& params) { params[3] = 200.0; }
+
+                static int design(const ParamArray& params, Biquad* sections) {
+                    AnalogPrototype proto;
+                    Prototype::linkwitzRiley(evenOrder(params[idOrder], MaxOrder), proto);
+                    return Dsp::design(proto, Response::bandPass, params, params[3], 1.0, sections, MaxSections);
+                }
+            };
+        }
+    }
+}
@@ -27,6 +27,9 @@
 
 enum { OSC_SINE, OSC_SQUARE, OSC_SAW, OSC_NOISE};
 
+// Per-voice filter: the classic SVF/biquad, or the resonant ZDF ladder
+enum { FILTER_MODEL_CLASSIC, FILTER_MODEL_LADDER, NUM_FILTER_MODELS };
+
 enum {
 	VOLUME_A_SLIDER, VOLUME_D_SLIDER, VOLUME_R_SLIDER,
 	FILTER_A_SLIDER, FILTER_D_SLIDER, FILTER_R_SLIDER,
@@ -59,7 +62,7 @@ enum {
 	FILTER_A_PARAM, FILTER_D_PARAM, FILTER_R_PARAM, VOLUME_S_PARAM, FILTER_S_PARAM,
 	REVERB_LEN_PARAM, REVERB_MIX_PARAM, DELAY_LEN_PARAM, DELAY_FEEDBACK_PARAM, 
 	DELAY_MIX_PARAM, CHORUS_MODAMT_PARAM, CHORUS_MOD_SPEED_PARAM, CHORUS_MIX_PARAM,
-	LFO_RATE_PARAM, LFO_AMP_PARAM, FILTER_START_PARAM, FILTER_END_PARAM, NUM_ALL_PARAMS
+	LFO_RATE_PARAM, LFO_AMP_PARAM, FILTER_START_PARAM, FILTER_END_PARAM, GLIDE_TIME_PARAM, NUM_ALL_PARAMS
 };
 
 constexpr int PLUGIN_CHANNELS = 2;
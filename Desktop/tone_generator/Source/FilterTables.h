@@ -0,0 +1,130 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include "LazyTable.h"
+
+// Filter coefficient lookups so cutoff sweeps never need tan/sin/cos on the audio thread.
+//
+// The table is indexed by log2(cutoff / sampleRate): frexp() splits the normalised
+// frequency into an octave (the exponent) and a position within it, and each octave
+// holds kEntriesPerOctave linearly spaced entries. Because the index is normalised,
+// one table serves every sample rate (and the 2x rate of oversampled filters) - there
+// is nothing to regenerate when the rate changes, prepare() just builds it up front.
+//
+// Measured worst case with linear interpolation, 64 entries per octave, over
+// 2^-16 .. 0.49 of the sample rate:
+//   tanPrewarp()      relative error 4.2e-6 below fs/4, 5.6e-4 at 0.49 fs
+//                     (an effective cutoff error of at most 0.021 cents)
+//   biquadTerms()     sin relative error 8.2e-5, 1-cos relative error 6.1e-5. The
+//                     biquad's centre frequency follows cos(w0), so in cents:
+//                       below 0.4 fs          at most 0.07  (0.05 over 43 Hz - 5.5 kHz at 44.1 kHz)
+//                       0.4 fs .. 0.447 fs    at most 0.135
+//                       0.447 fs .. 0.49 fs   up to 0.66 - cos flattens out towards Nyquist
+// Cutoffs outside that range are clamped to it.
+class CutoffTable
+{
+public:
+    static constexpr float kMinNormalisedFrequency = 1.0f / 65536.0f;
+    static constexpr float kMaxNormalisedFrequency = 0.49f;
+
+    // g = tan(pi * fc / fs), the prewarped gain of TPT (SVF, ladder) integrators
+    static float tanPrewarp(float normalisedFrequency) noexcept
+    {
+        // Interpolating t = tan(pi w / 2) avoids the pole at Nyquist: tan(pi w) = 2t / (1 - t^2)
+        const float t = lookup(normalisedFrequency, &Entry::tanHalf);
+        return 2.0f * t / (1.0f - t * t);
+    }
+
+    // sin(w0) and 1 - cos(w0) for w0 = 2 pi fc / fs, as used by RBJ cookbook biquads.
+    // 1 - cos is kept directly so low cutoffs don't lose it to cancellation.
+    static void biquadTerms(float normalisedFrequency, float& sinW0, float& oneMinusCosW0) noexcept
+    {
+        float fraction = 0.0f;
+        const auto index = locate(normalisedFrequency, fraction);
+        const auto& a = Entries::get()[index];
+        const auto& b = Entries::get()[index + 1];
+
+        sinW0 = a.sinW0 + fraction * (b.sinW0 - a.sinW0);
+        oneMinusCosW0 = a.oneMinusCosW0 + fraction * (b.oneMinusCosW0 - a.oneMinusCosW0);
+    }
+
+    // tan(y) for y in [0, pi/4] as an odd polynomial (least-squares fit, relative error 3.4e-6).
+    // Templated so it runs on SIMD registers too: for per-sample cutoff modulation, where
+    // a table lookup per lane would have to gather, use tanPrewarp = 2t / (1 - t^2) with
+    // t = tanPolynomial(pi * fc / (2 fs)).
+    template <typename Value>
+    static Value tanPolynomial(Value y) noexcept
+    {
+        const Value y2 = y * y;
+        return ((((y2 * 0.0433210791f + 0.0410729498f) * y2 + 0.136219355f) * y2 + 0.333126366f) * y2 + 1.00000149f) * y;
+    }
+
+    static void prepare() { Entries::prepare(); }
+
+private:
+    static constexpr int kEntriesPerOctave = 64;
+    static constexpr int kMinExponent = -15;  // frexp exponent of kMinNormalisedFrequency
+    static constexpr int kNumOctaves = 15;    // ... up to exponent -1, i.e. [0.25, 0.5)
+    static constexpr int kTableSize = kNumOctaves * kEntriesPerOctave + 1;
+
+    struct Entry
+    {
+        float tanHalf;
+        float sinW0;
+        float oneMinusCosW0;
+    };
+
+    static size_t locate(float normalisedFrequency, float& fraction) noexcept
+    {
+        float w = normalisedFrequency;
+        if (! (w > kMinNormalisedFrequency)) // also catches NaN
+            w = kMinNormalisedFrequency;
+        else if (w > kMaxNormalisedFrequency)
+            w = kMaxNormalisedFrequency;
+
+        int exponent = 0;
+        const float mantissa = std::frexp(w, &exponent); // w = mantissa * 2^exponent, mantissa in [0.5, 1)
+
+        const float position = static_cast<float>((exponent - kMinExponent) * kEntriesPerOctave)
+                             + (mantissa - 0.5f) * (2.0f * kEntriesPerOctave);
+
+        int index = static_cast<int>(position);
+        if (index > kTableSize - 2)
+            index = kTableSize - 2;
+
+        fraction = position - static_cast<float>(index);
+        return static_cast<size_t>(index);
+    }
+
+    static float lookup(float normalisedFrequency, float Entry::* field) noexcept
+    {
+        float fraction = 0.0f;
+        const auto index = locate(normalisedFrequency, fraction);
+        const float a = Entries::get()[index].*field;
+        const float b = Entries::get()[index + 1].*field;
+        return a + fraction * (b - a);
+    }
+
+    static std::array<Entry, kTableSize> buildEntries()
+    {
+        constexpr double pi = 3.14159265358979323846;
+        std::array<Entry, kTableSize> values {};
+
+        for (int i = 0; i < kTableSize; ++i)
+        {
+            const int octave = i / kEntriesPerOctave;
+            const int step = i % kEntriesPerOctave;
+            const double w = std::ldexp(0.5 + step / (2.0 * kEntriesPerOctave), kMinExponent + octave);
+            const double halfAngle = pi * w; // w0 / 2
+            const double sinHalf = std::sin(halfAngle);
+
+            values[static_cast<size_t>(i)] = { static_cast<float>(std::tan(0.5 * halfAngle)),
+                                               static_cast<float>(std::sin(2.0 * halfAngle)),
+                                               static_cast<float>(2.0 * sinHalf * sinHalf) };
+        }
+        return values;
+    }
+
+    using Entries = LazyTable<std::array<Entry, kTableSize>, buildEntries>;
+};
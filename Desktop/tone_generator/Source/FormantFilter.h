@@ -0,0 +1,159 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include "SVFBank.h"
+
+// Vowel colour: 3-5 parallel band-pass resonators per channel, morphing between
+// vowel targets. Every resonator of every channel is a lane of one SVFBank, so the
+// whole stage runs as a single vector pass; coefficients are only recomputed when
+// the vowel, formant count or sample rate change (control rate).
+// The bank is sized for the worst case in the constructor, so nothing allocates
+// after construction.
+class FormantFilter
+{
+public:
+    static constexpr int kMaxFormants = 5;
+    static constexpr int kMaxChannels = 2;
+    static constexpr int kMaxBlockSize = 32;
+
+    enum Vowel { vowelA, vowelE, vowelI, vowelO, vowelU, numVowels };
+
+    explicit FormantFilter(int numChannelsToUse)
+        : numChannels(juce::jlimit(1, kMaxChannels, numChannelsToUse))
+    {
+        bank.prepare(44100.0, numChannels * kMaxFormants, kMaxBlockSize);
+        bank.setType(SVFBank::Type::bandpass);
+        setNumFormants(kMaxFormants);
+    }
+
+    void setSampleRate(double newSampleRate) noexcept
+    {
+        bank.setSampleRate(newSampleRate);
+        coefficientsNeedUpdate = true;
+    }
+
+    void reset() noexcept { bank.reset(); }
+
+    // 3-5 resonators; the weaker upper formants are dropped first
+    void setNumFormants(int count) noexcept
+    {
+        numFormants = juce::jlimit(3, kMaxFormants, count);
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int f = 0; f < kMaxFormants; ++f)
+                bank.setLaneEnabled(ch * kMaxFormants + f, f < numFormants);
+    }
+
+    // 0 = A, 1 = E, 2 = I, 3 = O, 4 = U - fractional positions morph between neighbours
+    void setVowel(float position) noexcept
+    {
+        const float limited = juce::jlimit(0.0f, static_cast<float>(numVowels - 1), position);
+        if (limited != vowelPosition)
+        {
+            vowelPosition = limited;
+            coefficientsNeedUpdate = true;
+        }
+    }
+
+    // Dry/wet balance, 1 = formants only
+    void setMix(float wet) noexcept { mix = juce::jlimit(0.0f, 1.0f, wet); }
+
+    // Filters numChannels channels in place
+    void process(float* const* channels, int numSamples) noexcept
+    {
+        if (coefficientsNeedUpdate)
+            updateCoefficients();
+
+        const int stride = bank.getLaneStride();
+        const float dryGain = 1.0f - mix;
+
+        for (int start = 0; start < numSamples; start += kMaxBlockSize)
+        {
+            const int count = juce::jmin(kMaxBlockSize, numSamples - start);
+
+            // Fan each channel out to its resonators
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                const float* input = channels[ch] + start;
+                for (int f = 0; f < numFormants; ++f)
+                {
+                    float* lane = bank.getLaneData(ch * kMaxFormants + f);
+                    for (int i = 0; i < count; ++i)
+                        lane[i * stride] = input[i];
+                }
+            }
+
+            bank.process(count);
+
+            // ...and sum them back, each scaled to its formant level
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                float* output = channels[ch] + start;
+                const float* lanes = bank.getLaneData(ch * kMaxFormants);
+
+                for (int i = 0; i < count; ++i)
+                {
+                    const float* frame = lanes + i * stride;
+                    float wet = 0.0f;
+                    for (int f = 0; f < numFormants; ++f)
+                        wet += frame[f] * formantGains[static_cast<size_t>(f)];
+
+                    output[i] = output[i] * dryGain + wet * mix;
+                }
+            }
+        }
+    }
+
+private:
+    struct Formant
+    {
+        float frequency;  // Hz
+        float bandwidth;  // Hz
+        float level;      // dB relative to the first formant
+    };
+
+    // Tenor vowel formants (the common Csound/Peterson-Barney style table)
+    static constexpr Formant kVowels[numVowels][kMaxFormants] = {
+        { { 650.0f,  80.0f,  0.0f }, { 1080.0f, 90.0f, -6.0f },  { 2650.0f, 120.0f, -7.0f },  { 2900.0f, 130.0f, -8.0f },  { 3250.0f, 140.0f, -22.0f } }, // A
+        { { 400.0f,  70.0f,  0.0f }, { 1700.0f, 80.0f, -14.0f }, { 2600.0f, 100.0f, -12.0f }, { 3200.0f, 120.0f, -14.0f }, { 3580.0f, 120.0f, -20.0f } }, // E
+        { { 290.0f,  40.0f,  0.0f }, { 1870.0f, 90.0f, -15.0f }, { 2800.0f, 100.0f, -18.0f }, { 3250.0f, 120.0f, -20.0f }, { 3540.0f, 120.0f, -30.0f } }, // I
+        { { 400.0f,  40.0f,  0.0f }, { 800.0f,  80.0f, -10.0f }, { 2600.0f, 100.0f, -12.0f }, { 2800.0f, 120.0f, -12.0f }, { 3000.0f, 120.0f, -26.0f } }, // O
+        { { 350.0f,  40.0f,  0.0f }, { 600.0f,  60.0f, -20.0f }, { 2700.0f, 100.0f, -17.0f }, { 2900.0f, 120.0f, -14.0f }, { 3300.0f, 120.0f, -26.0f } }  // U
+    };
+
+    // Narrow band-passes pass far less energy than the dry signal - roughly level-match a saw
+    static constexpr float kMakeupGain = 4.0f;
+
+    void updateCoefficients() noexcept
+    {
+        coefficientsNeedUpdate = false;
+
+        const int lower = juce::jmin(static_cast<int>(vowelPosition), numVowels - 2);
+        const float fraction = vowelPosition - static_cast<float>(lower);
+
+        for (int f = 0; f < kMaxFormants; ++f)
+        {
+            const auto& a = kVowels[lower][f];
+            const auto& b = kVowels[lower + 1][f];
+
+            const float frequency = a.frequency + fraction * (b.frequency - a.frequency);
+            const float bandwidth = a.bandwidth + fraction * (b.bandwidth - a.bandwidth);
+            const float level = a.level + fraction * (b.level - a.level);
+            const float q = frequency / bandwidth;
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                bank.setLaneParameters(ch * kMaxFormants + f, frequency, q);
+
+            // The SVF band-pass peaks at Q - divide it out so each formant peaks at its level
+            formantGains[static_cast<size_t>(f)] = juce::Decibels::decibelsToGain(level) * kMakeupGain / q;
+        }
+    }
+
+    const int numChannels;
+    SVFBank bank;
+    std::array<float, kMaxFormants> formantGains {};
+    int numFormants = kMaxFormants;
+    float vowelPosition = 0.0f;
+    float mix = 1.0f;
+    bool coefficientsNeedUpdate = true;
+};
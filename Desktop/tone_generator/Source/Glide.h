@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cmath>
+
+// Portamento ramp expressed as a pitch offset in cents from the target note.
+// Moving linearly in cents gives an exponential frequency ramp; the offset is
+// advanced once per block and turned into a ratio with CentsTable.
+class GlideRamp
+{
+public:
+    enum class Mode { off, constantTime, constantRate };
+
+    void setMode(Mode newMode) noexcept { mode = newMode; }
+    Mode getMode() const noexcept { return mode; }
+
+    // Constant-time: every glide takes this long regardless of interval
+    void setGlideTime(float seconds) noexcept { glideTime = seconds > 0.0f ? seconds : 0.0f; }
+
+    // Constant-rate: speed in semitones per second, so wider intervals take longer
+    void setGlideRate(float semitonesPerSecond) noexcept { glideRate = semitonesPerSecond > 0.0f ? semitonesPerSecond : 0.0f; }
+
+    // Starts gliding from fromCents (relative to the new target) back to zero
+    void start(float fromCents, double sampleRate) noexcept
+    {
+        offsetCents = fromCents;
+        stepCents = 0.0f;
+
+        float duration = 0.0f;
+        if (mode == Mode::constantTime)
+            duration = glideTime;
+        else if (mode == Mode::constantRate && glideRate > 0.0f)
+            duration = std::abs(fromCents) / (glideRate * 100.0f);
+
+        const float glideSamples = duration * static_cast<float>(sampleRate);
+        if (mode == Mode::off || glideSamples < 1.0f || fromCents == 0.0f)
+            offsetCents = 0.0f;
+        else
+            stepCents = std::abs(fromCents) / glideSamples;
+    }
+
+    void reset() noexcept { offsetCents = 0.0f; stepCents = 0.0f; }
+
+    bool isGliding() const noexcept { return offsetCents != 0.0f; }
+
+    // Current offset in cents (for pitch bookkeeping, e.g. retargeting mid-glide)
+    float getCurrentOffset() const noexcept { return offsetCents; }
+
+    // Returns the offset for the block about to be rendered, then moves on by numSamples
+    float advance(int numSamples) noexcept
+    {
+        const float blockOffset = offsetCents;
+        if (offsetCents != 0.0f)
+        {
+            const float delta = stepCents * static_cast<float>(numSamples);
+            if (std::abs(offsetCents) <= delta)
+                offsetCents = 0.0f;
+            else
+                offsetCents += offsetCents > 0.0f ? -delta : delta;
+        }
+        return blockOffset;
+    }
+
+private:
+    Mode mode = Mode::off;
+    float glideTime = 0.1f;   // seconds
+    float glideRate = 24.0f;  // semitones per second
+    float offsetCents = 0.0f;
+    float stepCents = 0.0f;   // cents per sample
+};
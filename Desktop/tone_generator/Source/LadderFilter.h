@@ -0,0 +1,193 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <cmath>
+#include <memory>
+#include "FilterTables.h"
+
+// Zero-delay-feedback 4-pole transistor ladder (TPT form), along the lines of
+// juce::dsp::LadderFilter but trimmed for per-voice use:
+//  - coefficients are worked out in the setters (control rate), never per sample,
+//    and only when the cutoff, resonance or rate actually change
+//  - a single rational tanh approximation at the feedback junction replaces the
+//    per-stage std::tanh
+//  - optional 2x oversampling through a polyphase IIR half-band, which keeps
+//    high resonant sweeps in tune and folds back less of the saturation
+// Audio is processed in chunks of at most kMaxBlockSize samples, so the
+// oversampler is sized once in the constructor and nothing allocates afterwards.
+class LadderFilter
+{
+public:
+    static constexpr int kMaxChannels = 2;
+    static constexpr int kMaxBlockSize = 32;
+
+    enum class Mode { lowPass12, lowPass24 };
+
+    explicit LadderFilter(int numChannelsToUse)
+        : numChannels(juce::jlimit(1, kMaxChannels, numChannelsToUse)),
+          oversampler(std::make_unique<juce::dsp::Oversampling<float>>(static_cast<size_t>(numChannels), 1,
+                                                                         juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR,
+                                                                         false))
+    {
+        oversampler->initProcessing(static_cast<size_t>(kMaxBlockSize));
+        CutoffTable::prepare();
+        reset();
+    }
+
+    void setSampleRate(double newSampleRate) noexcept
+    {
+        if (newSampleRate != sampleRate)
+        {
+            sampleRate = newSampleRate;
+            updateCoefficients();
+        }
+    }
+
+    void reset() noexcept
+    {
+        for (auto& channelState : state)
+            channelState.fill(0.0f);
+        oversampler->reset();
+    }
+
+    void setMode(Mode newMode) noexcept { mode = newMode; }
+
+    // Switching rate clears the filter and oversampler state (a one-off discontinuity)
+    void setOversampling(bool shouldOversample) noexcept
+    {
+        if (shouldOversample == oversampling)
+            return;
+
+        oversampling = shouldOversample;
+        reset();
+        updateCoefficients();
+    }
+
+    bool isOversampling() const noexcept { return oversampling; }
+
+    void setCutoffFrequencyHz(float newCutoff) noexcept
+    {
+        if (newCutoff != cutoff)
+        {
+            cutoff = newCutoff;
+            updateCoefficients();
+        }
+    }
+
+    // 0..1, self-oscillation starts just below 1
+    void setResonance(float newResonance) noexcept
+    {
+        const float limited = juce::jlimit(0.0f, 1.0f, newResonance);
+        if (limited != resonance)
+        {
+            resonance = limited;
+            updateCoefficients();
+        }
+    }
+
+    // Input gain into the saturator (1 = clean for normal levels)
+    void setDrive(float newDrive) noexcept { drive = juce::jmax(1.0f, newDrive); }
+
+    // Maps the biquad/SVF style Q used elsewhere in the engine onto ladder resonance,
+    // so a voice can switch filter model without retuning (Q 0.5 -> 0, Q 5 -> 0.9)
+    static float resonanceFromQ(float q) noexcept
+    {
+        return juce::jlimit(0.0f, 0.98f, 1.0f - 0.5f / juce::jmax(0.5f, q));
+    }
+
+    // Filters numChannels channels in place
+    void process(float* const* channels, int numSamples) noexcept
+    {
+        for (int start = 0; start < numSamples; start += kMaxBlockSize)
+        {
+            const int count = juce::jmin(kMaxBlockSize, numSamples - start);
+
+            float* chunk[kMaxChannels] {};
+            for (int ch = 0; ch < numChannels; ++ch)
+                chunk[ch] = channels[ch] + start;
+
+            if (oversampling)
+            {
+                juce::dsp::AudioBlock<float> block(chunk, static_cast<size_t>(numChannels), static_cast<size_t>(count));
+                auto upsampled = oversampler->processSamplesUp(block);
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                    processChannel(upsampled.getChannelPointer(static_cast<size_t>(ch)), ch, static_cast<int>(upsampled.getNumSamples()));
+
+                oversampler->processSamplesDown(block);
+            }
+            else
+            {
+                for (int ch = 0; ch < numChannels; ++ch)
+                    processChannel(chunk[ch], ch, count);
+            }
+        }
+    }
+
+private:
+    // Cheap tanh: Pade approximant, exact at +-3 where it clamps to +-1
+    static float saturate(float x) noexcept
+    {
+        const float clipped = juce::jlimit(-3.0f, 3.0f, x);
+        const float squared = clipped * clipped;
+        return clipped * (27.0f + squared) / (27.0f + 9.0f * squared);
+    }
+
+    void updateCoefficients() noexcept
+    {
+        const double rate = sampleRate * (oversampling ? 2.0 : 1.0);
+        const float g = CutoffTable::tanPrewarp(static_cast<float>(cutoff / rate));
+
+        G = g / (1.0f + g);
+        beta = 1.0f - G;
+        G2 = G * G;
+        G3 = G2 * G;
+        G4 = G3 * G;
+
+        k = 4.0f * resonance;
+        feedbackScale = 1.0f / (1.0f + k * G4);
+        compensation = 1.0f + 0.5f * k; // recovers half of the passband loss from the feedback
+    }
+
+    void processChannel(float* data, int channel, int numSamples) noexcept
+    {
+        auto& s = state[static_cast<size_t>(channel)];
+        const bool twelveDb = mode == Mode::lowPass12;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            // Solve the zero-delay feedback loop linearly, then saturate the junction
+            const float sigma = beta * (G3 * s[0] + G2 * s[1] + G * s[2] + s[3]);
+            const float u = saturate((drive * data[i] - k * sigma) * feedbackScale);
+
+            float input = u;
+            float stage2 = 0.0f;
+            for (int stage = 0; stage < 4; ++stage)
+            {
+                const float v = (input - s[static_cast<size_t>(stage)]) * G;
+                const float y = v + s[static_cast<size_t>(stage)];
+                s[static_cast<size_t>(stage)] = y + v;
+                input = y;
+                if (stage == 1)
+                    stage2 = y;
+            }
+
+            data[i] = (twelveDb ? stage2 : input) * compensation;
+        }
+    }
+
+    const int numChannels;
+    std::unique_ptr<juce::dsp::Oversampling<float>> oversampler;
+    std::array<std::array<float, 4>, kMaxChannels> state {};
+
+    double sampleRate = 44100.0;
+    float cutoff = 1000.0f;
+    float resonance = 0.0f;
+    float drive = 1.0f;
+    bool oversampling = false;
+    Mode mode = Mode::lowPass24;
+
+    float G = 0.0f, G2 = 0.0f, G3 = 0.0f, G4 = 0.0f, beta = 1.0f;
+    float k = 0.0f, feedbackScale = 1.0f, compensation = 1.0f;
+};
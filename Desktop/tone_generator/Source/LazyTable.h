@@ -0,0 +1,16 @@
+#pragma once
+
+// A lookup table built once, by build(), the first time it's asked for. Building one can
+// take long enough to glitch a callback, so the tables' prepare() calls (from prepare code,
+// never the audio thread) make sure the first audio-thread lookup finds it ready.
+template <typename Table, Table (*build)()>
+struct LazyTable
+{
+    static const Table& get()
+    {
+        static const Table table = build();
+        return table;
+    }
+
+    static void prepare() { get(); }
+};
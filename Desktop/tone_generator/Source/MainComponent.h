@@ -6,6 +6,10 @@
 #include "Theme.h"
 #include "LookAndFeelMinimal.h"
 #include "LookAndFeelKeyTiles.h"
+#include "SmoothingBank.h"
+#include "MasterEQ.h"
+#include "QualityController.h"
+#include "NoteLatencyProbe.h"
 
 // Using the new LookAndFeelMinimal for cleaner, more minimal design
 // Using LookAndFeelKeyTiles for specialized note key tile rendering
@@ -34,7 +38,7 @@ public:
 
 private:
     // STK-based synthesizer
-    juce::Synthesiser synth;
+    OscilSynthesiser synth;
     juce::MidiKeyboardState keyboardState;
     
     // Custom look and feel
@@ -48,15 +52,26 @@ private:
     // Global chorus effect for stereo width
     juce::dsp::Chorus<float> chorus;
     
-    // Smoothed values for global effects to eliminate zipper noise
-    juce::SmoothedValue<float> smoothedReverbRoomSize;
-    juce::SmoothedValue<float> smoothedReverbDamping;
-    juce::SmoothedValue<float> smoothedReverbWet;
-    juce::SmoothedValue<float> smoothedReverbDry;
-    juce::SmoothedValue<float> smoothedReverbWidth;
-    juce::SmoothedValue<float> smoothedChorusRate;
-    juce::SmoothedValue<float> smoothedChorusDepth;
-    juce::SmoothedValue<float> smoothedChorusMix;
+    // Master EQ at the very end of the chain - live IIR, or linear phase for mastering ('Q')
+    MasterEQ masterEQ;
+    
+    // Smoothed values for global effects to eliminate zipper noise. The UI writes
+    // targets, the audio thread picks them up and ramps them once per block
+    enum EffectsParameter
+    {
+        smoothedReverbRoomSize,
+        smoothedReverbDamping,
+        smoothedReverbWet,
+        smoothedReverbDry,
+        smoothedReverbWidth,
+        smoothedChorusRate,
+        smoothedChorusDepth,
+        smoothedChorusMix,
+        numEffectsParameters
+    };
+    SmoothingBank<numEffectsParameters, 32> effectsSmoothing;
+    std::array<std::atomic<float>, numEffectsParameters> effectsTargets;
+    void setEffectsTarget(EffectsParameter parameter, float value);
     
     // Pre-allocated effects buffer to avoid real-time allocations
     juce::AudioBuffer<float> effectsBuffer;
@@ -65,10 +80,13 @@ private:
     double currentSampleRate = 0.0;
     int currentBlockSize = 0;
     
-    // Performance monitoring and optimization
-    int performanceMode = 0; // 0=normal, 1=reduced, 2=minimal
-    int cpuUsageCounter = 0;
-    static constexpr int CPU_MONITOR_INTERVAL = 1000; // Check every 1000 audio blocks
+    // Performance monitoring and optimization - the quality tier follows the measured
+    // callback load, and a tier without effects fades the send/return out before skipping it
+    QualityController qualityController;
+    int performanceMode = 0; // QualityController tier: 0=full .. 3=minimal
+    static constexpr float effectsReturnLevel = 0.15f; // 15% return from effects for softer sound
+    juce::SmoothedValue<float> effectsReturn { effectsReturnLevel };
+    bool effectsSuspended = false;
     
     // Main UI components
     juce::FlexBox mainFlexBox;
@@ -101,33 +119,63 @@ private:
     juce::Component playPanel;          // holds notes/chords/volume/labels/divider
     juce::Viewport advancedVP;
     struct AdvancedPanel : juce::Component {
-        std::array<std::unique_ptr<juce::Slider>, 25> sliders; // Added 3 chorus controls
-        std::array<std::unique_ptr<juce::Label>, 25>  labels;  // Added 3 chorus controls
+        // Sliders 0-24 are the original synth/effects set, read by updateAdvancedControls().
+        // Those after them, and the toggles, write ParameterHolder directly and follow it
+        // through refreshParameterControls().
+        enum : int
+        {
+            eqFirstSlider = 25, // gain, frequency and Q of each master EQ band in turn
+            glideSlider = eqFirstSlider + 3 * MasterEQ::kNumBands,
+            ladderResonanceSlider,
+            formantVowelSlider,
+            filterFMSlider,
+            stealPolicySlider,
+            numSliders
+        };
+        enum : int
+        {
+            eqLinearPhaseToggle,
+            legatoToggle,
+            ladderToggle,
+            oversamplingToggle,
+            formantToggle,
+            parallelRenderToggle,
+            numToggles
+        };
+        std::array<std::unique_ptr<juce::Slider>, numSliders> sliders;
+        std::array<std::unique_ptr<juce::Label>, numSliders>  labels;
+        std::array<std::unique_ptr<juce::ToggleButton>, numToggles> toggles;
+        
+        // Controls in display order, each with its label below (toggles carry their own
+        // text); a null control leaves its cell empty
+        struct Cell { juce::Component* control; juce::Label* label; };
+        std::vector<Cell> cells;
+        
+        static constexpr int cols = 3, rowH = 80, gap = 8, margin = 8;
+        
+        int getRequiredHeight() const {
+            const int rows = (static_cast<int>(cells.size()) + cols - 1) / cols;
+            return 2 * margin + rows * rowH + juce::jmax(0, rows - 1) * gap;
+        }
+        
         void resized() override {
-            auto r = getLocalBounds().reduced(8);
-            const int gap = 8;
-            const int cols = 3, rows = 9; // Updated for 25 sliders (3x9 = 27, fits 25)
-
+            auto r = getLocalBounds().reduced(margin);
             int colW = (r.getWidth() - (cols - 1) * gap) / cols;
-            int rowH = 80; // Fixed height for each row to ensure sliders are visible
 
-            // Simple manual layout for better control
-            int sliderIndex = 0;
-            for (int row = 0; row < rows && sliderIndex < 25; ++row) {
-                for (int col = 0; col < cols && sliderIndex < 25; ++col) {
-                    int x = r.getX() + col * (colW + gap);
-                    int y = r.getY() + row * (rowH + gap);
-                    
-                    // Layout slider with label below
-                    auto sliderBounds = juce::Rectangle<int>(x, y, colW, rowH - 20);
-                    auto labelBounds = juce::Rectangle<int>(x, y + rowH - 18, colW, 18);
-                    
-                    if (sliderIndex < static_cast<int>(sliders.size())) {
-                        sliders[static_cast<size_t>(sliderIndex)]->setBounds(sliderBounds);
-                        labels[static_cast<size_t>(sliderIndex)]->setBounds(labelBounds);
-                    }
-                    
-                    sliderIndex++;
+            for (size_t i = 0; i < cells.size(); ++i) {
+                const int row = static_cast<int>(i) / cols, col = static_cast<int>(i) % cols;
+                int x = r.getX() + col * (colW + gap);
+                int y = r.getY() + row * (rowH + gap);
+                
+                if (cells[i].control == nullptr)
+                    continue;
+                
+                // Layout control with label below
+                if (cells[i].label != nullptr) {
+                    cells[i].control->setBounds(x, y, colW, rowH - 20);
+                    cells[i].label->setBounds(x, y + rowH - 18, colW, 18);
+                } else {
+                    cells[i].control->setBounds(x, y, colW, rowH);
                 }
             }
         }
@@ -143,8 +191,22 @@ private:
     void onAudioRouteChanged();
     
     
-    // State persistence
+    // State persistence - the timer loads it once after construction, then writes any
+    // save requested since (requestSaveState) once things have been quiet for a moment
     std::unique_ptr<juce::PropertiesFile> propertiesFile;
+    static constexpr int saveStateDelayMs = 500;
+    bool stateLoaded = false;
+    bool saveStatePending = false;
+    
+    // Touch-to-sound latency of the note buttons - the latest one is shown in the 'D' dialog
+    NoteLatencyProbe latencyProbe;
+    NoteLatencyProbe::Measurement lastNoteLatency {};
+    bool hasNoteLatency = false;
+    
+    // Scala tuning loader (press 'T') - the loaded .scl is saved and reloaded with the state
+    std::unique_ptr<juce::FileChooser> tuningChooser;
+    juce::File tuningFile;
+    void chooseTuningFile();
     
     // Layout constants - responsive design
     static constexpr int MIN_BUTTON_SIZE = 44; // Minimum 44pt for proper hit targets
@@ -173,11 +235,12 @@ private:
     void setWave(int idx);
     
     void updateAdvancedControls();
-    void updateEffectsParameters(); // Update effects parameters when UI controls change
+    void refreshParameterControls(); // advancedPanel's ParameterHolder-backed controls, from ParameterHolder
+    void updateEffectsParameters(); // Apply the current smoothed effects values (audio thread)
     void updateNoteButtonVisualFeedback();
     
     // Performance optimization methods
-    void adjustPerformanceSettings();
+    void adjustPerformanceSettings(int numSamples);
     void setPerformanceMode(int mode);
     
     // Responsive design helper methods
@@ -207,6 +270,7 @@ private:
     // State persistence
     void initializePropertiesFile();
     void saveState();
+    void requestSaveState(); // Deferred saveState() for the note path
     void loadState();
     void saveSettings();
     void loadSettings();
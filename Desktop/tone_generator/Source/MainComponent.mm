@@ -1,6 +1,16 @@
 #include "MainComponent.h"
 #include <algorithm>
 
+namespace
+{
+    // VoiceAllocator::StealPolicy, in order
+    const juce::StringArray& getStealPolicyNames()
+    {
+        static const juce::StringArray names { "Oldest", "Quietest", "Same Note", "Released First" };
+        return names;
+    }
+}
+
 #if JUCE_IOS
 #import <AVFoundation/AVFoundation.h>
 #import <UIKit/UIKit.h>
@@ -43,18 +53,31 @@ MainComponent::MainComponent()
     chorus.setMix(0.15f);         // Gentle chorus for warmth
     
     // Initialize smoothed values for warm, soft effects (50ms smoothing time)
-    smoothedReverbRoomSize.reset(44100, 0.6f);   // Smaller room for warmth
-    smoothedReverbDamping.reset(44100, 0.7f);    // Higher damping for softer tone
-    smoothedReverbWet.reset(44100, 0.25f);       // Moderate reverb for warmth
-    smoothedReverbDry.reset(44100, 0.9f);        // More dry signal for clarity
-    smoothedReverbWidth.reset(44100, 0.8f);      // Narrower width for warmth
-    smoothedChorusRate.reset(44100, 0.12f);      // Gentle rate for softness
-    smoothedChorusDepth.reset(44100, 0.2f);      // Subtle modulation
-    smoothedChorusMix.reset(44100, 0.15f);       // Gentle chorus for warmth
+    const std::array<float, numEffectsParameters> initialEffects {
+        0.6f,   // Reverb room size - smaller room for warmth
+        0.7f,   // Reverb damping - higher damping for softer tone
+        0.25f,  // Reverb wet - moderate reverb for warmth
+        0.9f,   // Reverb dry - more dry signal for clarity
+        0.8f,   // Reverb width - narrower width for warmth
+        0.12f,  // Chorus rate - gentle rate for softness
+        0.2f,   // Chorus depth - subtle modulation
+        0.15f   // Chorus mix - gentle chorus for warmth
+    };
+    for (int i = 0; i < numEffectsParameters; ++i)
+    {
+        effectsTargets[static_cast<size_t>(i)].store(initialEffects[static_cast<size_t>(i)]);
+        effectsSmoothing.setCurrentAndTargetValue(i, initialEffects[static_cast<size_t>(i)]);
+    }
     
     // Initialize performance monitoring
-    performanceMode = 0; // Start in normal mode
-    cpuUsageCounter = 0;
+    performanceMode = 0; // Start at full quality
+    latencyProbe.onMeasurement = [this](const NoteLatencyProbe::Measurement& m)
+    {
+        lastNoteLatency = m;
+        hasNoteLatency = true;
+        DBG("Note " << m.midiNote << " latency: press->noteOn " << m.pressToNoteOnMs << " ms, noteOn->sound "
+            << m.noteOnToSoundMs << " ms, total " << m.totalMs() << " ms");
+    };
     
     // Initialize state persistence (defer loading for better startup performance)
     initializePropertiesFile();
@@ -111,8 +134,9 @@ void MainComponent::setupNoteButtons()
     {
         noteButtons[i].setButtonText(noteNames[i]);
         noteButtons[i].setClickingTogglesState(true); // Enable toggle behavior - buttons stay "down" when active
+        noteButtons[i].setTriggeredOnMouseDown(true); // Sound on touch-down, not on release
         noteButtons[i].onClick = [this, i] { 
-            std::cout << "LAMBDA CALLED for button " << i << std::endl;
+            latencyProbe.buttonPressed();
             onNoteButtonClicked(static_cast<int>(i)); 
         };
         
@@ -192,7 +216,7 @@ void MainComponent::setupAdvancedControlsBasic()
     // Initialize advanced panel viewport (but without sliders)
     addAndMakeVisible(advancedVP);
     advancedVP.setViewedComponent(&advancedPanel, false);
-    advancedVP.setScrollBarsShown(false, false); // hide both scrollbars completely
+    advancedVP.setScrollBarsShown(false, false, true, false); // hide both scrollbars, still scroll vertically
     advancedVP.getVerticalScrollBar().setColour(juce::ScrollBar::thumbColourId, juce::Colours::transparentBlack);
     advancedVP.getVerticalScrollBar().setColour(juce::ScrollBar::trackColourId, juce::Colours::transparentBlack);
     advancedVP.setVisible(false); // default hidden
@@ -216,6 +240,16 @@ void MainComponent::createAdvancedSliders()
         advancedPanel.addAndMakeVisible(s);
     };
     
+    auto makeToggle = [&](int i, const juce::String& name, std::function<void(bool)> apply) {
+        advancedPanel.toggles[static_cast<size_t>(i)] = std::make_unique<juce::ToggleButton>(name);
+        auto& t = *advancedPanel.toggles[static_cast<size_t>(i)];
+        t.setColour(juce::ToggleButton::textColourId, Theme::text);
+        t.setColour(juce::ToggleButton::tickColourId, Theme::accent);
+        t.setColour(juce::ToggleButton::tickDisabledColourId, Theme::textDim);
+        t.onClick = [this, &t, apply] { apply(t.getToggleState()); requestSaveState(); };
+        advancedPanel.addAndMakeVisible(t);
+    };
+    
     make(0, "Detune"); make(1, "Osc Mix"); make(2, "Attack"); make(3, "Decay");
     make(4, "Sustain"); make(5, "Release"); make(6, "Filter Cutoff"); make(7, "Resonance");
     make(8, "Filter Env Amt"); make(9, "Filter Env A"); make(10, "Filter Env D"); make(11, "Filter Env S");
@@ -261,12 +295,138 @@ void MainComponent::createAdvancedSliders()
     
     for (size_t i = 0; i < 25; ++i) { // Updated for 25 sliders
         advancedPanel.labels[i]->setText(paramNames[static_cast<int>(i)], juce::dontSendNotification);
-        advancedPanel.labels[i]->setJustificationType(juce::Justification::centred);
-        advancedPanel.labels[i]->setColour(juce::Label::textColourId, Theme::textDim);
-        advancedPanel.labels[i]->setFont(Theme::label(0.8f)); // Smaller font for parameter names
-        advancedPanel.addAndMakeVisible(advancedPanel.labels[i].get());
     }
     
+    // Master EQ - a row per band: gain, frequency, Q
+    static const char* const bandNames[] = { "Low Shelf", "Low Mid", "High Mid", "High Shelf" };
+    for (int band = 0; band < MasterEQ::kNumBands; ++band)
+    {
+        const int first = AdvancedPanel::eqFirstSlider + 3 * band;
+        const auto index = static_cast<size_t>(band);
+        make(first, "EQ Gain"); make(first + 1, "EQ Frequency"); make(first + 2, "EQ Q");
+        
+        auto& gain = *advancedPanel.sliders[static_cast<size_t>(first)];
+        gain.setRange(-12.0, 12.0, 0.5);
+        gain.setTextValueSuffix(" dB");
+        gain.onValueChange = [this, index, &gain] { ParameterHolder::inst().masterEQGain[index].store(static_cast<float>(gain.getValue())); requestSaveState(); };
+        
+        auto& frequency = *advancedPanel.sliders[static_cast<size_t>(first + 1)];
+        frequency.setRange(20.0, 20000.0, 1.0);
+        frequency.setSkewFactorFromMidPoint(1000.0);
+        frequency.setTextValueSuffix(" Hz");
+        frequency.onValueChange = [this, index, &frequency] { ParameterHolder::inst().masterEQFrequency[index].store(static_cast<float>(frequency.getValue())); requestSaveState(); };
+        
+        auto& q = *advancedPanel.sliders[static_cast<size_t>(first + 2)];
+        q.setRange(0.3, 10.0, 0.01);
+        q.setSkewFactorFromMidPoint(1.0);
+        q.onValueChange = [this, index, &q] { ParameterHolder::inst().masterEQQ[index].store(static_cast<float>(q.getValue())); requestSaveState(); };
+        
+        advancedPanel.labels[static_cast<size_t>(first)]->setText(juce::String(bandNames[band]) + " dB", juce::dontSendNotification);
+        advancedPanel.labels[static_cast<size_t>(first + 1)]->setText(juce::String(bandNames[band]) + " Hz", juce::dontSendNotification);
+        advancedPanel.labels[static_cast<size_t>(first + 2)]->setText(juce::String(bandNames[band]) + " Q", juce::dontSendNotification);
+    }
+    
+    makeToggle(AdvancedPanel::eqLinearPhaseToggle, "Linear Phase EQ",
+               [] (bool on) { ParameterHolder::inst().masterEQLinearPhase.store(on); });
+    
+    // Portamento and legato, beside the envelope
+    make(AdvancedPanel::glideSlider, "Glide");
+    auto& glide = *advancedPanel.sliders[AdvancedPanel::glideSlider];
+    glide.setRange(0.0, 1.0, 0.001);
+    glide.setSkewFactorFromMidPoint(0.15);
+    glide.setTextValueSuffix(" s");
+    glide.onValueChange = [this, &glide] { ParameterHolder::inst().parameters[GLIDE_TIME_PARAM].store(static_cast<float>(glide.getValue())); requestSaveState(); };
+    advancedPanel.labels[AdvancedPanel::glideSlider]->setText("Glide", juce::dontSendNotification);
+    
+    makeToggle(AdvancedPanel::legatoToggle, "Legato",
+               [] (bool on) { ParameterHolder::inst().legato.store(on); });
+    
+    // Ladder filter model, its resonance and 2x oversampling, beside the classic filter
+    makeToggle(AdvancedPanel::ladderToggle, "Ladder Filter",
+               [] (bool on) { ParameterHolder::inst().filterModel.store(on ? FILTER_MODEL_LADDER : FILTER_MODEL_CLASSIC); });
+    make(AdvancedPanel::ladderResonanceSlider, "Ladder Res");
+    auto& ladderResonance = *advancedPanel.sliders[AdvancedPanel::ladderResonanceSlider];
+    ladderResonance.setRange(0.0, 0.98, 0.01); // self-oscillation starts just below 1
+    ladderResonance.onValueChange = [this, &ladderResonance] { ParameterHolder::inst().ladderResonance.store(static_cast<float>(ladderResonance.getValue())); requestSaveState(); };
+    advancedPanel.labels[AdvancedPanel::ladderResonanceSlider]->setText("Ladder Res", juce::dontSendNotification);
+    makeToggle(AdvancedPanel::oversamplingToggle, "Ladder 2x",
+               [] (bool on) { ParameterHolder::inst().filterOversampling.store(on); });
+    
+    // Formant stage - vowel 0..4 morphs A E I O U
+    makeToggle(AdvancedPanel::formantToggle, "Formant",
+               [] (bool on) { ParameterHolder::inst().formantEnabled.store(on); });
+    make(AdvancedPanel::formantVowelSlider, "Vowel");
+    auto& vowel = *advancedPanel.sliders[AdvancedPanel::formantVowelSlider];
+    vowel.setRange(0.0, FormantFilter::numVowels - 1, 0.01);
+    vowel.onValueChange = [this, &vowel] { ParameterHolder::inst().formantVowel.store(static_cast<float>(vowel.getValue())); requestSaveState(); };
+    advancedPanel.labels[AdvancedPanel::formantVowelSlider]->setText("Vowel A-U", juce::dontSendNotification);
+    
+    // Audio-rate filter FM (classic filter only)
+    make(AdvancedPanel::filterFMSlider, "Filter FM");
+    auto& filterFM = *advancedPanel.sliders[AdvancedPanel::filterFMSlider];
+    filterFM.setRange(0.0, 1.0, 0.01);
+    filterFM.onValueChange = [this, &filterFM] { ParameterHolder::inst().filterFMAmount.store(static_cast<float>(filterFM.getValue())); requestSaveState(); };
+    advancedPanel.labels[AdvancedPanel::filterFMSlider]->setText("Filter FM", juce::dontSendNotification);
+    
+    // Voice rendering across worker threads
+    makeToggle(AdvancedPanel::parallelRenderToggle, "Parallel Voices",
+               [] (bool on) { ParameterHolder::inst().parallelVoiceRendering.store(on); });
+    
+    // Voice stealing policy, shown by name
+    make(AdvancedPanel::stealPolicySlider, "Voice Steal");
+    auto& stealPolicy = *advancedPanel.sliders[AdvancedPanel::stealPolicySlider];
+    stealPolicy.textFromValueFunction = [] (double value) { return getStealPolicyNames()[juce::roundToInt(value)]; };
+    stealPolicy.valueFromTextFunction = [] (const juce::String& text) { return static_cast<double>(juce::jmax(0, getStealPolicyNames().indexOf(text, true))); };
+    stealPolicy.setRange(0.0, static_cast<double>(VoiceAllocator::StealPolicy::numPolicies) - 1.0, 1.0);
+    stealPolicy.onValueChange = [this, &stealPolicy] { ParameterHolder::inst().voiceStealPolicy.store(static_cast<VoiceAllocator::StealPolicy>(juce::roundToInt(stealPolicy.getValue()))); requestSaveState(); };
+    advancedPanel.labels[AdvancedPanel::stealPolicySlider]->setText("Voice Steal", juce::dontSendNotification);
+    
+    for (auto& label : advancedPanel.labels) {
+        label->setJustificationType(juce::Justification::centred);
+        label->setColour(juce::Label::textColourId, Theme::textDim);
+        label->setFont(Theme::label(0.8f)); // Smaller font for parameter names
+        advancedPanel.addAndMakeVisible(label.get());
+    }
+    
+    // Display order - rows of three
+    auto& cells = advancedPanel.cells;
+    auto slider = [&](int i) { cells.push_back({ advancedPanel.sliders[static_cast<size_t>(i)].get(), advancedPanel.labels[static_cast<size_t>(i)].get() }); };
+    auto toggle = [&](int i) { cells.push_back({ advancedPanel.toggles[static_cast<size_t>(i)].get(), nullptr }); };
+    auto endRow = [&] { while (cells.size() % AdvancedPanel::cols != 0) cells.push_back({ nullptr, nullptr }); };
+    
+    cells.clear();
+    for (int i = 0; i < 6; ++i)
+        slider(i);
+    slider(AdvancedPanel::glideSlider);
+    toggle(AdvancedPanel::legatoToggle);
+    endRow();
+    slider(6);
+    slider(7);
+    endRow();
+    toggle(AdvancedPanel::ladderToggle);
+    slider(AdvancedPanel::ladderResonanceSlider);
+    toggle(AdvancedPanel::oversamplingToggle);
+    for (int i = 8; i < 17; ++i)
+        slider(i);
+    toggle(AdvancedPanel::formantToggle);
+    slider(AdvancedPanel::formantVowelSlider);
+    slider(AdvancedPanel::filterFMSlider);
+    endRow();
+    for (int i = 17; i < 25; ++i)
+        slider(i);
+    endRow();
+    toggle(AdvancedPanel::parallelRenderToggle);
+    slider(AdvancedPanel::stealPolicySlider);
+    endRow();
+    
+    toggle(AdvancedPanel::eqLinearPhaseToggle);
+    endRow();
+    for (int i = AdvancedPanel::eqFirstSlider; i < AdvancedPanel::eqFirstSlider + 3 * MasterEQ::kNumBands; ++i)
+        slider(i);
+    
+    refreshParameterControls();
+    advancedPanel.resized();
+    
     // Set up accessibility focus order for the newly created sliders
     setupAdvancedAccessibilityFocusOrder();
 }
@@ -323,8 +483,11 @@ void MainComponent::prepareToPlay(int samplesPerBlockExpected, double sampleRate
     
     try
     {
-        // Set current playback sample rate for STK synthesizer
-        synth.setCurrentPlaybackSampleRate(sampleRate);
+        // Sample rate and the parallel voice render pool
+        synth.prepare(sampleRate, samplesPerBlockExpected);
+        
+        // Build the filter coefficient table before any voice retunes a filter
+        CutoffTable::prepare();
         
         // Reset keyboard state
         keyboardState.reset();
@@ -365,6 +528,9 @@ void MainComponent::prepareToPlay(int samplesPerBlockExpected, double sampleRate
         chorus.setFeedback(0.05f);    // Reduced feedback for softer sound
         chorus.setMix(1.0f);          // 100% wet output (auxiliary path)
         
+        // Master EQ - also designs its first linear-phase FIR, before any audio runs
+        masterEQ.prepare(spec);
+        
         // Allocate effects buffer once for reuse (largest expected block size)
         const int maxBlockSize = juce::jlimit(32, 4096, samplesPerBlockExpected);
         effectsBuffer.setSize(2, maxBlockSize); // Stereo buffer for largest block size
@@ -372,16 +538,14 @@ void MainComponent::prepareToPlay(int samplesPerBlockExpected, double sampleRate
         
         DBG("Chorus parameters set - Rate: " << 0.15f << ", Depth: " << 0.4f << ", Mix: " << 1.0f);
         
+        // Quality tiers start from the current one with a fresh load measurement
+        qualityController.prepare(sampleRate, samplesPerBlockExpected);
+        effectsReturn.reset(sampleRate, 0.1);
+        effectsReturn.setCurrentAndTargetValue(QualityController::getTier(performanceMode).effectsEnabled ? effectsReturnLevel : 0.0f);
+        
         // Configure smoothed values with 50ms smoothing time (buttery smooth)
         const float smoothingTimeMs = 50.0f; // 30-80ms range, using 50ms for buttery smooth
-        smoothedReverbRoomSize.reset(sampleRate, smoothingTimeMs / 1000.0f);
-        smoothedReverbDamping.reset(sampleRate, smoothingTimeMs / 1000.0f);
-        smoothedReverbWet.reset(sampleRate, smoothingTimeMs / 1000.0f);
-        smoothedReverbDry.reset(sampleRate, smoothingTimeMs / 1000.0f);
-        smoothedReverbWidth.reset(sampleRate, smoothingTimeMs / 1000.0f);
-        smoothedChorusRate.reset(sampleRate, smoothingTimeMs / 1000.0f);
-        smoothedChorusDepth.reset(sampleRate, smoothingTimeMs / 1000.0f);
-        smoothedChorusMix.reset(sampleRate, smoothingTimeMs / 1000.0f);
+        effectsSmoothing.reset(sampleRate, smoothingTimeMs / 1000.0f);
         
         // Track current device settings for effects re-preparation
         currentSampleRate = sampleRate;
@@ -412,6 +576,8 @@ void MainComponent::prepareToPlay(int samplesPerBlockExpected, double sampleRate
 
 void MainComponent::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
 {
+    latencyProbe.blockStarted();
+    
     // Safety check - if audio isn't initialized, just clear the buffer
     if (!isAudioInitialized || bufferToFill.buffer == nullptr || bufferToFill.numSamples == 0)
     {
@@ -425,6 +591,10 @@ void MainComponent::getNextAudioBlock(const juce::AudioSourceChannelInfo& buffer
     // Performance optimization: Denormal protection for older devices
     juce::ScopedNoDenormals noDenormals;
     
+    // Quality tier from the load measured over earlier callbacks, then time this one
+    adjustPerformanceSettings(bufferToFill.numSamples);
+    const juce::AudioProcessLoadMeasurer::ScopedTimer loadTimer(qualityController.getLoadMeasurer(), bufferToFill.numSamples);
+    
     try
     {
         // 1. Render STK synthesizer audio with MIDI from keyboard state
@@ -465,17 +635,8 @@ void MainComponent::getNextAudioBlock(const juce::AudioSourceChannelInfo& buffer
         preRms = std::sqrt(preRms / (bufferToFill.numSamples * bufferToFill.buffer->getNumChannels()));
         DBG("MAIN AUDIO: Before synth render - RMS: " << preRms);
         
-        // Debug: Count active voices before rendering
-        int activeVoices = 0;
-        for (int i = 0; i < synth.getNumVoices(); ++i) {
-            if (auto* voice = dynamic_cast<OscilVoice*>(synth.getVoice(i))) {
-                if (voice->isVoiceActive()) {
-                    activeVoices++;
-                }
-            }
-        }
-        
         synth.renderNextBlock(*bufferToFill.buffer, midiBuffer, bufferToFill.startSample, bufferToFill.numSamples);
+        latencyProbe.processBlock(*bufferToFill.buffer, bufferToFill.startSample, bufferToFill.numSamples, currentSampleRate);
         
         // Debug: Check buffer after synth rendering
         float postRms = 0.0f;
@@ -486,22 +647,40 @@ void MainComponent::getNextAudioBlock(const juce::AudioSourceChannelInfo& buffer
             }
         }
         postRms = std::sqrt(postRms / (bufferToFill.numSamples * bufferToFill.buffer->getNumChannels()));
-        DBG("MAIN AUDIO: After synth render - RMS: " << postRms << " (Active voices: " << activeVoices << ")");
-        
-        // 1.5. Performance monitoring and optimization
-        adjustPerformanceSettings();
+        DBG("MAIN AUDIO: After synth render - RMS: " << postRms << " (Active voices: " << synth.getNumActiveVoices() << ")");
         
         // Apply gentle gain reduction for softer sound
         bufferToFill.buffer->applyGain(bufferToFill.startSample, bufferToFill.numSamples, 0.8f);
         
         // 2.5. Update smoothed parameters in real-time for buttery smooth transitions
-        // NOTE: Effects parameters are now set once in prepareToPlay for optimal performance
-        // Only update if UI parameters have changed (handled elsewhere)
+        // Targets set by the UI are picked up here; nothing is touched while they are at rest
+        for (int i = 0; i < numEffectsParameters; ++i)
+            effectsSmoothing.setTargetValue(i, effectsTargets[static_cast<size_t>(i)].load(std::memory_order_relaxed));
+        
+        if (effectsSmoothing.isAnySmoothing())
+        {
+            effectsSmoothing.advance(bufferToFill.numSamples);
+            updateEffectsParameters();
+        }
         
         // 3. Apply FX as Auxiliary Send/Return (Fixed Implementation)
         // Use pre-allocated effects buffer to avoid real-time allocations
-        if (effectsBuffer.getNumSamples() >= bufferToFill.numSamples)
+        const bool effectsAudible = effectsReturn.isSmoothing() || effectsReturn.getTargetValue() > 0.0f;
+        if (! effectsAudible)
+        {
+            // The quality tier has faded the send out - skip reverb and chorus entirely
+            effectsSuspended = true;
+        }
+        else if (effectsBuffer.getNumSamples() >= bufferToFill.numSamples)
         {
+            // Coming back after a suspension: start the tails from silence under the fade-in
+            if (effectsSuspended)
+            {
+                reverb.reset();
+                chorus.reset();
+                effectsSuspended = false;
+            }
+            
             // Clear the effects buffer for this block
             effectsBuffer.clear();
             
@@ -530,10 +709,11 @@ void MainComponent::getNextAudioBlock(const juce::AudioSourceChannelInfo& buffer
             
             // Mix effects back with dry signal (auxiliary return)
             // Effects are now 100% wet, so we add them to the dry signal
-            const float effectsReturn = 0.15f; // 15% return from effects for softer sound
+            const float returnStart = effectsReturn.getCurrentValue();
+            const float returnEnd = effectsReturn.skip(bufferToFill.numSamples);
             
             for (int ch = 0; ch < juce::jmin(numInputChannels, channelsToProcess); ++ch) {
-                bufferToFill.buffer->addFrom(ch, bufferToFill.startSample, effectsBuffer, ch, 0, bufferToFill.numSamples, effectsReturn);
+                bufferToFill.buffer->addFromWithRamp(ch, bufferToFill.startSample, effectsBuffer.getReadPointer(ch), bufferToFill.numSamples, returnStart, returnEnd);
             }
         }
         else
@@ -542,6 +722,16 @@ void MainComponent::getNextAudioBlock(const juce::AudioSourceChannelInfo& buffer
             DBG("WARNING: Effects buffer too small (" << effectsBuffer.getNumSamples() << " < " << bufferToFill.numSamples << "), skipping effects");
         }
         
+        // Master EQ over the whole mix, effects returns included
+        {
+            auto& params = ParameterHolder::inst();
+            for (int band = 0; band < MasterEQ::kNumBands; ++band)
+                masterEQ.setBand(band, params.masterEQFrequency[static_cast<size_t>(band)].load(),
+                                 params.masterEQGain[static_cast<size_t>(band)].load(), params.masterEQQ[static_cast<size_t>(band)].load());
+            masterEQ.setMode(params.masterEQLinearPhase.load() ? MasterEQ::Mode::linearPhase : MasterEQ::Mode::live);
+            masterEQ.process(*bufferToFill.buffer, bufferToFill.startSample, bufferToFill.numSamples);
+        }
+        
         // Debug: Check FINAL buffer after all processing
         float finalRms = 0.0f;
         for (int ch = 0; ch < bufferToFill.buffer->getNumChannels(); ++ch) {
@@ -627,13 +817,8 @@ void MainComponent::resized()
         advancedVP.setVisible(true);
         advancedVP.setBounds(content);
 
-        // Give the inner content a fixed larger height to allow scrolling
-        const int innerGap = 12;
-        const int rows = 4; /*, cols = 3;*/
-        const int rowH = 100; // slider column height; adjust to taste
-        const int innerH = rows * rowH + (rows - 1) * innerGap + 24;
-
-        advancedPanel.setSize(content.getWidth(), innerH);
+        // The inner content is as tall as its rows and scrolls inside the viewport
+        advancedPanel.setSize(content.getWidth(), advancedPanel.getRequiredHeight());
         
         // Debug logging for verification
         juce::Logger::writeToLog("Advanced Controls ON: playPanel vis=" + juce::String((int)playPanel.isVisible()) 
@@ -777,23 +962,9 @@ void MainComponent::layoutCompactNoteGrid(juce::Rectangle<int> bounds)
 
 void MainComponent::onNoteButtonClicked(int noteIndex)
 {
-    // Force debug output to console
-    std::cout << "=== NOTE BUTTON CLICKED: " << noteIndex << " ===" << std::endl;
-    std::cout << "isAudioInitialized: " << (isAudioInitialized ? "true" : "false") << std::endl;
-    
-    DBG("=== NOTE BUTTON CLICKED: " << noteIndex << " ===");
-    DBG("isAudioInitialized: " << (isAudioInitialized ? "true" : "false"));
-    
-    // Add haptic feedback on iOS
-    triggerHapticFeedback();
-    
-    // Force immediate repaint for instant visual feedback
-    noteButtons[noteIndex].repaint();
-    
     // Audio is now initialized in constructor, just check if it's ready
     if (!isAudioInitialized)
     {
-        DBG("Audio not initialized - returning early");
         // Audio initialization failed - user was already notified
         return;
     }
@@ -801,45 +972,27 @@ void MainComponent::onNoteButtonClicked(int noteIndex)
     // Hook the UI to MIDI note numbers and velocities that aren't zero
     const int midiNote = 60 + noteIndex;   // C4 + offset
     const bool on = noteButtons[noteIndex].getToggleState();
-
-    DBG("Button " << noteIndex << " toggle state: " << (on ? "ON" : "OFF"));
     
-    // Debug: Show current state of all buttons
-    DBG("=== ALL BUTTON STATES ===");
-    for (int i = 0; i < 12; ++i) {
-        bool buttonState = noteButtons[i].getToggleState();
-        DBG("Button " << i << ": " << (buttonState ? "ON" : "OFF"));
-    }
-    DBG("=== END BUTTON STATES ===");
-
+    // The note goes to the keyboard state first - feedback, bookkeeping and persistence
+    // all come after it, and nothing here logs
     if (on)  
     {
-        DBG("=== Triggering note ON: " << midiNote << " (velocity: 0.9) ===");
-        
-        // Debug: Check voice allocation before triggering note
-        int availableVoices = 0;
-        int busyVoices = 0;
-        for (int i = 0; i < synth.getNumVoices(); ++i) {
-            if (auto* voice = dynamic_cast<OscilVoice*>(synth.getVoice(i))) {
-                if (voice->isVoiceActive()) {
-                    busyVoices++;
-                } else {
-                    availableVoices++;
-                }
-            }
-        }
-        DBG("Before note ON - Busy voices: " << busyVoices << ", Available voices: " << availableVoices);
+        // Measured from silence only - a stolen note still fading out on a tail voice counts
+        if (synth.getNumActiveVoices() == 0 && synth.getNumActiveTailVoices() == 0)
+            latencyProbe.aboutToSendNoteOn(midiNote);
         
         keyboardState.noteOn(1, midiNote, 0.9f);
     }
     else     
     {
-        DBG("=== Triggering note OFF: " << midiNote << " (velocity: 0.9) ===");
         keyboardState.noteOff(1, midiNote, 0.9f);
     }
     
-    // Debug: Show keyboard state
-    DBG("KeyboardState - isNoteOn for note " << midiNote << ": " << (keyboardState.isNoteOn(1, midiNote) ? "true" : "false"));
+    // Add haptic feedback on iOS
+    triggerHapticFeedback();
+    
+    // Force immediate repaint for instant visual feedback
+    noteButtons[noteIndex].repaint();
     
     // If we're not currently playing, start playing automatically
     if (on && !isPlaying)
@@ -869,8 +1022,8 @@ void MainComponent::onNoteButtonClicked(int noteIndex)
     // Update UI feedback
     updateNoteButtonVisualFeedback();
     
-    // Save state
-    saveState();
+    // Save state once the playing has settled rather than on every press
+    requestSaveState();
 }
 
 
@@ -959,71 +1112,78 @@ void MainComponent::updateAdvancedControls()
     // as the STK system doesn't have direct equivalents for these parameters
     
     // Reverb controls - use smoothed values for buttery smooth transitions
-    bool reverbChanged = false;
-    if (advancedPanel.sliders[17]) {
-        smoothedReverbRoomSize.setTargetValue(static_cast<float>(advancedPanel.sliders[17]->getValue()));
-        reverbChanged = true;
-    }
-    if (advancedPanel.sliders[18]) {
-        smoothedReverbDamping.setTargetValue(static_cast<float>(advancedPanel.sliders[18]->getValue()));
-        reverbChanged = true;
-    }
-    if (advancedPanel.sliders[19]) {
-        smoothedReverbWet.setTargetValue(static_cast<float>(advancedPanel.sliders[19]->getValue()));
-        reverbChanged = true;
-    }
-    if (advancedPanel.sliders[20]) {
-        smoothedReverbDry.setTargetValue(static_cast<float>(advancedPanel.sliders[20]->getValue()));
-        reverbChanged = true;
-    }
-    if (advancedPanel.sliders[21]) {
-        smoothedReverbWidth.setTargetValue(static_cast<float>(advancedPanel.sliders[21]->getValue()));
-        reverbChanged = true;
-    }
+    if (advancedPanel.sliders[17]) setEffectsTarget(smoothedReverbRoomSize, static_cast<float>(advancedPanel.sliders[17]->getValue()));
+    if (advancedPanel.sliders[18]) setEffectsTarget(smoothedReverbDamping, static_cast<float>(advancedPanel.sliders[18]->getValue()));
+    if (advancedPanel.sliders[19]) setEffectsTarget(smoothedReverbWet, static_cast<float>(advancedPanel.sliders[19]->getValue()));
+    if (advancedPanel.sliders[20]) setEffectsTarget(smoothedReverbDry, static_cast<float>(advancedPanel.sliders[20]->getValue()));
+    if (advancedPanel.sliders[21]) setEffectsTarget(smoothedReverbWidth, static_cast<float>(advancedPanel.sliders[21]->getValue()));
     
     // Chorus controls - use smoothed values for buttery smooth transitions
-    bool chorusChanged = false;
-    if (advancedPanel.sliders[22]) {
-        smoothedChorusRate.setTargetValue(static_cast<float>(advancedPanel.sliders[22]->getValue()));
-        chorusChanged = true;
-    }
-    if (advancedPanel.sliders[23]) {
-        smoothedChorusDepth.setTargetValue(static_cast<float>(advancedPanel.sliders[23]->getValue()));
-        chorusChanged = true;
-    }
-    if (advancedPanel.sliders[24]) {
-        smoothedChorusMix.setTargetValue(static_cast<float>(advancedPanel.sliders[24]->getValue()));
-        chorusChanged = true;
-    }
+    if (advancedPanel.sliders[22]) setEffectsTarget(smoothedChorusRate, static_cast<float>(advancedPanel.sliders[22]->getValue()));
+    if (advancedPanel.sliders[23]) setEffectsTarget(smoothedChorusDepth, static_cast<float>(advancedPanel.sliders[23]->getValue()));
+    if (advancedPanel.sliders[24]) setEffectsTarget(smoothedChorusMix, static_cast<float>(advancedPanel.sliders[24]->getValue()));
     
-    // Update effects parameters only when reverb or chorus controls change
-    if (reverbChanged || chorusChanged) {
-        updateEffectsParameters();
-    }
+    // The audio thread ramps towards the new targets and updates the effects as it goes
     
     // Save state when advanced controls change
     saveState();
 }
 
+void MainComponent::refreshParameterControls()
+{
+    // Nothing to refresh until the panel has been opened
+    if (advancedPanel.toggles[0] == nullptr)
+        return;
+    
+    const auto& params = ParameterHolder::inst();
+    auto setSlider = [&](int i, float value) { advancedPanel.sliders[static_cast<size_t>(i)]->setValue(value, juce::dontSendNotification); };
+    auto setToggle = [&](int i, bool on) { advancedPanel.toggles[static_cast<size_t>(i)]->setToggleState(on, juce::dontSendNotification); };
+    
+    for (int band = 0; band < MasterEQ::kNumBands; ++band)
+    {
+        const auto index = static_cast<size_t>(band);
+        setSlider(AdvancedPanel::eqFirstSlider + 3 * band, params.masterEQGain[index].load());
+        setSlider(AdvancedPanel::eqFirstSlider + 3 * band + 1, params.masterEQFrequency[index].load());
+        setSlider(AdvancedPanel::eqFirstSlider + 3 * band + 2, params.masterEQQ[index].load());
+    }
+    setToggle(AdvancedPanel::eqLinearPhaseToggle, params.masterEQLinearPhase.load());
+    
+    setSlider(AdvancedPanel::glideSlider, params.parameters[GLIDE_TIME_PARAM].load());
+    setToggle(AdvancedPanel::legatoToggle, params.legato.load());
+    
+    setToggle(AdvancedPanel::ladderToggle, params.filterModel.load() == FILTER_MODEL_LADDER);
+    setSlider(AdvancedPanel::ladderResonanceSlider, params.ladderResonance.load());
+    setToggle(AdvancedPanel::oversamplingToggle, params.filterOversampling.load());
+    
+    setToggle(AdvancedPanel::formantToggle, params.formantEnabled.load());
+    setSlider(AdvancedPanel::formantVowelSlider, params.formantVowel.load());
+    setSlider(AdvancedPanel::filterFMSlider, params.filterFMAmount.load());
+    
+    setToggle(AdvancedPanel::parallelRenderToggle, params.parallelVoiceRendering.load());
+    setSlider(AdvancedPanel::stealPolicySlider, static_cast<float>(params.voiceStealPolicy.load()));
+}
+
+void MainComponent::setEffectsTarget(EffectsParameter parameter, float value)
+{
+    effectsTargets[static_cast<size_t>(parameter)].store(value, std::memory_order_relaxed);
+}
+
 void MainComponent::updateEffectsParameters()
 {
-    // Only update effects parameters if device settings have changed
-    // This method should be called when UI controls change, not every audio block
+    // Called from the audio thread, and only on blocks where an effects parameter is ramping
     
     // Update reverb parameters with current smoothed values
-    reverbParams.roomSize = smoothedReverbRoomSize.getCurrentValue();
-    reverbParams.damping = smoothedReverbDamping.getCurrentValue();
+    reverbParams.roomSize = effectsSmoothing.getCurrentValue(smoothedReverbRoomSize);
+    reverbParams.damping = effectsSmoothing.getCurrentValue(smoothedReverbDamping);
     reverbParams.wetLevel = 1.0f; // Always 100% wet for auxiliary send/return
     reverbParams.dryLevel = 0.0f; // Always 0% dry for auxiliary send/return
-    reverbParams.width = smoothedReverbWidth.getCurrentValue();
+    reverbParams.width = effectsSmoothing.getCurrentValue(smoothedReverbWidth);
     reverb.setParameters(reverbParams);
     
     // Update chorus parameters with current smoothed values
-    chorus.setRate(smoothedChorusRate.getCurrentValue());
-    chorus.setDepth(smoothedChorusDepth.getCurrentValue());
+    chorus.setRate(effectsSmoothing.getCurrentValue(smoothedChorusRate));
+    chorus.setDepth(effectsSmoothing.getCurrentValue(smoothedChorusDepth));
     chorus.setMix(1.0f); // Always 100% wet for auxiliary send/return
-    
-    DBG("Effects parameters updated - Reverb: " << reverbParams.roomSize << ", Chorus: " << smoothedChorusRate.getCurrentValue());
 }
 
 void MainComponent::updateNoteButtonVisualFeedback()
@@ -1161,20 +1321,31 @@ void MainComponent::updateResponsiveLayout()
 
 void MainComponent::timerCallback()
 {
-    // Stop the timer - we only want to load state once
+    // One-shot - restarted by requestSaveState()
     stopTimer();
     
-    std::cout << "=== Timer callback: Loading saved state after UI construction ===" << std::endl;
-    std::cout.flush();
-    
-    // Load state now that UI is ready
-    loadState();
-    
-    // Update synthesizer parameters with loaded UI values
-    updateAdvancedControls();
+    if (!stateLoaded)
+    {
+        stateLoaded = true;
+        
+        std::cout << "=== Timer callback: Loading saved state after UI construction ===" << std::endl;
+        std::cout.flush();
+        
+        // Load state now that UI is ready
+        loadState();
+        
+        // Update synthesizer parameters with loaded UI values
+        updateAdvancedControls();
+        
+        std::cout << "=== Timer callback: State loading completed ===" << std::endl;
+        std::cout.flush();
+    }
     
-    std::cout << "=== Timer callback: State loading completed ===" << std::endl;
-    std::cout.flush();
+    if (saveStatePending)
+    {
+        saveStatePending = false;
+        saveState();
+    }
 }
 
 void MainComponent::initialiseAudioSafely()
@@ -1419,6 +1590,41 @@ void MainComponent::saveState()
     if (advancedPanel.sliders[23]) propertiesFile->setValue("chorusDepth", advancedPanel.sliders[23]->getValue());
     if (advancedPanel.sliders[24]) propertiesFile->setValue("chorusMix", advancedPanel.sliders[24]->getValue());
     
+    // Master EQ bands and engine
+    for (int band = 0; band < MasterEQ::kNumBands; ++band)
+    {
+        const auto index = static_cast<size_t>(band);
+        propertiesFile->setValue("masterEQGain" + juce::String(band), ParameterHolder::inst().masterEQGain[index].load());
+        propertiesFile->setValue("masterEQFrequency" + juce::String(band), ParameterHolder::inst().masterEQFrequency[index].load());
+        propertiesFile->setValue("masterEQQ" + juce::String(band), ParameterHolder::inst().masterEQQ[index].load());
+    }
+    propertiesFile->setValue("masterEQLinearPhase", ParameterHolder::inst().masterEQLinearPhase.load());
+    
+    // Filter model, ladder resonance and oversampling
+    propertiesFile->setValue("filterModel", ParameterHolder::inst().filterModel.load());
+    propertiesFile->setValue("ladderResonance", ParameterHolder::inst().ladderResonance.load());
+    propertiesFile->setValue("filterOversampling", ParameterHolder::inst().filterOversampling.load());
+    
+    // Formant stage
+    propertiesFile->setValue("formantEnabled", ParameterHolder::inst().formantEnabled.load());
+    propertiesFile->setValue("formantVowel", ParameterHolder::inst().formantVowel.load());
+    
+    // Filter FM
+    propertiesFile->setValue("filterFMAmount", ParameterHolder::inst().filterFMAmount.load());
+    
+    // Parallel voice rendering
+    propertiesFile->setValue("parallelVoiceRendering", ParameterHolder::inst().parallelVoiceRendering.load());
+    
+    // Voice stealing policy
+    propertiesFile->setValue("voiceStealPolicy", static_cast<int>(ParameterHolder::inst().voiceStealPolicy.load()));
+    
+    // Portamento and legato ('G' / 'M')
+    propertiesFile->setValue("glideTime", ParameterHolder::inst().parameters[GLIDE_TIME_PARAM].load());
+    propertiesFile->setValue("legato", ParameterHolder::inst().legato.load());
+    
+    // Scala tuning ('T') - the matching .kbm is picked up from next to it again on load
+    propertiesFile->setValue("tuningFile", tuningFile.getFullPathName());
+    
     // Save the file
     propertiesFile->saveIfNeeded();
     DBG("State saved successfully");
@@ -1490,8 +1696,59 @@ void MainComponent::loadState()
     if (advancedPanel.sliders[23]) advancedPanel.sliders[23]->setValue(propertiesFile->getDoubleValue("chorusDepth", 0.45)); // Deeper modulation
     if (advancedPanel.sliders[24]) advancedPanel.sliders[24]->setValue(propertiesFile->getDoubleValue("chorusMix", 0.25)); // More chorus for richness
     
+    // Master EQ bands and engine
+    for (int band = 0; band < MasterEQ::kNumBands; ++band)
+    {
+        const auto index = static_cast<size_t>(band);
+        const auto& defaults = MasterEQ::kDefaultBands[index];
+        ParameterHolder::inst().masterEQGain[index].store(static_cast<float>(propertiesFile->getDoubleValue("masterEQGain" + juce::String(band), 0.0)));
+        ParameterHolder::inst().masterEQFrequency[index].store(static_cast<float>(propertiesFile->getDoubleValue("masterEQFrequency" + juce::String(band), defaults.frequency)));
+        ParameterHolder::inst().masterEQQ[index].store(static_cast<float>(propertiesFile->getDoubleValue("masterEQQ" + juce::String(band), defaults.q)));
+    }
+    ParameterHolder::inst().masterEQLinearPhase.store(propertiesFile->getBoolValue("masterEQLinearPhase", false));
+    
+    // Filter model, ladder resonance and oversampling
+    ParameterHolder::inst().filterModel.store(propertiesFile->getIntValue("filterModel", FILTER_MODEL_CLASSIC) == FILTER_MODEL_LADDER ? FILTER_MODEL_LADDER : FILTER_MODEL_CLASSIC);
+    ParameterHolder::inst().ladderResonance.store(static_cast<float>(propertiesFile->getDoubleValue("ladderResonance", 0.6)));
+    ParameterHolder::inst().filterOversampling.store(propertiesFile->getBoolValue("filterOversampling", false));
+    
+    // Formant stage
+    ParameterHolder::inst().formantEnabled.store(propertiesFile->getBoolValue("formantEnabled", false));
+    ParameterHolder::inst().formantVowel.store(static_cast<float>(juce::jlimit(0.0, FormantFilter::numVowels - 1.0, propertiesFile->getDoubleValue("formantVowel", 0.0))));
+    
+    // Filter FM
+    ParameterHolder::inst().filterFMAmount.store(static_cast<float>(juce::jlimit(0.0, 1.0, propertiesFile->getDoubleValue("filterFMAmount", 0.0))));
+    
+    // Parallel voice rendering
+    ParameterHolder::inst().parallelVoiceRendering.store(propertiesFile->getBoolValue("parallelVoiceRendering", false));
+    
+    // Voice stealing policy
+    {
+        using StealPolicy = VoiceAllocator::StealPolicy;
+        const int policy = propertiesFile->getIntValue("voiceStealPolicy", static_cast<int>(StealPolicy::releasedFirst));
+        ParameterHolder::inst().voiceStealPolicy.store(static_cast<StealPolicy>(juce::jlimit(0, static_cast<int>(StealPolicy::numPolicies) - 1, policy)));
+    }
+    
+    // Portamento and legato ('G' / 'M')
+    ParameterHolder::inst().parameters[GLIDE_TIME_PARAM].store(static_cast<float>(propertiesFile->getDoubleValue("glideTime", 0.0)));
+    ParameterHolder::inst().legato.store(propertiesFile->getBoolValue("legato", false));
+    
+    // Scala tuning ('T'), or equal temperament if the file has gone
+    const juce::String tuningPath = propertiesFile->getValue("tuningFile");
+    if (tuningPath.isNotEmpty() && juce::File::isAbsolutePath(tuningPath))
+    {
+        const juce::File sclFile(tuningPath);
+        const auto result = Tuning::inst().loadScala(sclFile, sclFile.withFileExtension("kbm"));
+        tuningFile = result.wasOk() ? sclFile : juce::File();
+        if (result.failed())
+        {
+            DBG("Saved tuning not loaded: " << result.getErrorMessage());
+        }
+    }
+    
     // Update synthesizer with loaded values
     updateAdvancedControls();
+    refreshParameterControls();
     
     // Update UI feedback
     updateNoteButtonVisualFeedback();
@@ -1499,6 +1756,13 @@ void MainComponent::loadState()
     DBG("State loaded successfully");
 }
 
+void MainComponent::requestSaveState()
+{
+    // Before the initial load the pending save simply rides along with it
+    saveStatePending = true;
+    startTimer(saveStateDelayMs);
+}
+
 void MainComponent::saveSettings()
 {
     saveState();
@@ -1534,9 +1798,9 @@ void MainComponent::setupAdvancedAccessibilityFocusOrder()
 {
     // Set up focus order for advanced controls sliders (called during lazy loading)
     int focusOrder = 20;
-    for (size_t i = 0; i < 25; ++i) { // Updated for 25 sliders
-        if (advancedPanel.sliders[i]) {
-            advancedPanel.sliders[i]->setExplicitFocusOrder(focusOrder++);
+    for (auto& cell : advancedPanel.cells) {
+        if (cell.control != nullptr) {
+            cell.control->setExplicitFocusOrder(focusOrder++);
         }
     }
 }
@@ -1555,7 +1819,15 @@ bool MainComponent::keyPressed(const juce::KeyPress& key)
             info += "Buffer Size: " + juce::String(device->getCurrentBufferSizeSamples()) + " samples\n";
             info += "Output Channels: " + juce::String(device->getOutputChannelNames().size()) + "\n";
             info += "Audio Initialized: " + juce::String(isAudioInitialized ? "Yes" : "No") + "\n";
-            info += "Polyphony: " + juce::String(synth.getNumVoices()) + " voices";
+            info += "Polyphony: " + juce::String(synth.getNumVoices()) + " voices\n";
+            info += "Output Latency: " + juce::String(device->getOutputLatencyInSamples()) + " samples\n";
+            
+            if (hasNoteLatency)
+                info += "Last Note Latency: " + juce::String(lastNoteLatency.totalMs(), 1) + " ms (touch to note-on "
+                      + juce::String(lastNoteLatency.pressToNoteOnMs, 1) + " ms, note-on to sound "
+                      + juce::String(lastNoteLatency.noteOnToSoundMs, 1) + " ms, before output latency)";
+            else
+                info += "Last Note Latency: play a note from silence to measure it";
             
             juce::AlertWindow::showMessageBoxAsync(
                 juce::AlertWindow::InfoIcon,
@@ -1576,68 +1848,197 @@ bool MainComponent::keyPressed(const juce::KeyPress& key)
         return true;
     }
     
+    // Press 'T' to load a Scala tuning (.scl, with a matching .kbm next to it if present)
+    if (key.getKeyCode() == 'T' || key.getKeyCode() == 't')
+    {
+        chooseTuningFile();
+        return true;
+    }
+    
+    // Press 'L' to switch every voice between the classic filter and the ladder,
+    // 'K' to step the ladder's resonance through 0 -> 0.3 -> 0.6 -> 0.8 -> 0.95 (just
+    // short of self-oscillation) -> 0, 'O' to toggle the ladder's 2x oversampling
+    if (key.getKeyCode() == 'L' || key.getKeyCode() == 'l')
+    {
+        auto& params = ParameterHolder::inst();
+        const int model = params.filterModel.load() == FILTER_MODEL_LADDER ? FILTER_MODEL_CLASSIC : FILTER_MODEL_LADDER;
+        params.filterModel.store(model);
+        DBG("Filter model: " << (model == FILTER_MODEL_LADDER ? "ladder" : "classic"));
+        refreshParameterControls();
+        requestSaveState();
+        return true;
+    }
+    
+    if (key.getKeyCode() == 'K' || key.getKeyCode() == 'k')
+    {
+        static constexpr std::array<float, 5> resonances { 0.0f, 0.3f, 0.6f, 0.8f, 0.95f };
+        auto& resonance = ParameterHolder::inst().ladderResonance;
+        const auto current = std::find_if(resonances.begin(), resonances.end(), [&](float r) { return r >= resonance.load(); });
+        const auto next = (current == resonances.end() || current + 1 == resonances.end()) ? resonances.begin() : current + 1;
+        resonance.store(*next);
+        DBG("Ladder resonance: " << *next);
+        refreshParameterControls();
+        requestSaveState();
+        return true;
+    }
+    
+    if (key.getKeyCode() == 'O' || key.getKeyCode() == 'o')
+    {
+        auto& params = ParameterHolder::inst();
+        params.filterOversampling.store(! params.filterOversampling.load());
+        DBG("Ladder oversampling: " << (params.filterOversampling.load() ? "on" : "off"));
+        refreshParameterControls();
+        requestSaveState();
+        return true;
+    }
+    
+    // Press 'V' to step the formant stage through off -> A -> E -> I -> O -> U -> off
+    if (key.getKeyCode() == 'V' || key.getKeyCode() == 'v')
+    {
+        auto& params = ParameterHolder::inst();
+        if (! params.formantEnabled.load())
+        {
+            params.formantVowel.store(0.0f);
+            params.formantEnabled.store(true);
+        }
+        else if (params.formantVowel.load() < static_cast<float>(FormantFilter::numVowels - 1))
+        {
+            params.formantVowel.store(std::floor(params.formantVowel.load()) + 1.0f);
+        }
+        else
+        {
+            params.formantEnabled.store(false);
+        }
+        DBG("Formant: " << (params.formantEnabled.load() ? juce::String(params.formantVowel.load()) : juce::String("off")));
+        refreshParameterControls();
+        requestSaveState();
+        return true;
+    }
+    
+    // Press 'F' to step audio-rate filter FM through off -> 25% -> 50% -> 100% -> off
+    if (key.getKeyCode() == 'F' || key.getKeyCode() == 'f')
+    {
+        auto& params = ParameterHolder::inst();
+        const float amount = params.filterFMAmount.load();
+        params.filterFMAmount.store(amount <= 0.0f ? 0.25f : (amount < 1.0f ? amount * 2.0f : 0.0f));
+        DBG("Filter FM: " << params.filterFMAmount.load());
+        refreshParameterControls();
+        requestSaveState();
+        return true;
+    }
+    
+    // Press 'Q' to switch the master EQ between live (IIR) and linear-phase mastering
+    if (key.getKeyCode() == 'Q' || key.getKeyCode() == 'q')
+    {
+        auto& params = ParameterHolder::inst();
+        params.masterEQLinearPhase.store(! params.masterEQLinearPhase.load());
+        DBG("Master EQ: " << (params.masterEQLinearPhase.load() ? "linear phase" : "live"));
+        refreshParameterControls();
+        requestSaveState();
+        return true;
+    }
+    
+    // Press 'P' to toggle rendering the voices across worker threads
+    if (key.getKeyCode() == 'P' || key.getKeyCode() == 'p')
+    {
+        auto& params = ParameterHolder::inst();
+        params.parallelVoiceRendering.store(! params.parallelVoiceRendering.load());
+        DBG("Parallel voice rendering: " << (params.parallelVoiceRendering.load() ? "on" : "off"));
+        refreshParameterControls();
+        requestSaveState();
+        return true;
+    }
+    
+    // Press 'G' to step portamento through off -> 50 ms -> 150 ms -> 400 ms -> off,
+    // 'M' to toggle legato (new notes glide the held voice instead of starting another)
+    if (key.getKeyCode() == 'G' || key.getKeyCode() == 'g')
+    {
+        static constexpr std::array<float, 4> glideTimes { 0.0f, 0.05f, 0.15f, 0.4f };
+        auto& glideTime = ParameterHolder::inst().parameters[GLIDE_TIME_PARAM];
+        const auto current = std::find_if(glideTimes.begin(), glideTimes.end(), [&](float t) { return t >= glideTime.load(); });
+        const auto next = (current == glideTimes.end() || current + 1 == glideTimes.end()) ? glideTimes.begin() : current + 1;
+        glideTime.store(*next);
+        DBG("Glide time: " << *next << " s");
+        refreshParameterControls();
+        requestSaveState();
+        return true;
+    }
+    
+    if (key.getKeyCode() == 'M' || key.getKeyCode() == 'm')
+    {
+        auto& params = ParameterHolder::inst();
+        params.legato.store(! params.legato.load());
+        DBG("Legato: " << (params.legato.load() ? "on" : "off"));
+        refreshParameterControls();
+        requestSaveState();
+        return true;
+    }
+    
+    // Press 'S' to cycle the voice stealing policy: oldest -> quietest -> same note -> released first
+    if (key.getKeyCode() == 'S' || key.getKeyCode() == 's')
+    {
+        using StealPolicy = VoiceAllocator::StealPolicy;
+        auto& params = ParameterHolder::inst();
+        const int next = (static_cast<int>(params.voiceStealPolicy.load()) + 1) % static_cast<int>(StealPolicy::numPolicies);
+        params.voiceStealPolicy.store(static_cast<StealPolicy>(next));
+        DBG("Voice stealing: " << getStealPolicyNames()[next]);
+        refreshParameterControls();
+        requestSaveState();
+        return true;
+    }
+    
     return false;
 }
 
-// Performance optimization methods
-void MainComponent::adjustPerformanceSettings()
+void MainComponent::chooseTuningFile()
 {
-    // Monitor CPU usage periodically
-    if (++cpuUsageCounter >= CPU_MONITOR_INTERVAL)
+    tuningChooser = std::make_unique<juce::FileChooser>("Load Scala tuning", juce::File(), "*.scl");
+    
+    tuningChooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+                               [this](const juce::FileChooser& chooser)
     {
-        cpuUsageCounter = 0;
+        const auto sclFile = chooser.getResult();
+        if (sclFile == juce::File())
+            return;
         
-        // Simple CPU monitoring: check if we're using too many voices
-        int activeVoices = 0;
-        for (int i = 0; i < synth.getNumVoices(); ++i)
+        const auto result = Tuning::inst().loadScala(sclFile, sclFile.withFileExtension("kbm"));
+        if (result.wasOk())
         {
-            if (auto* voice = synth.getVoice(i))
-            {
-                if (voice->isVoiceActive())
-                    activeVoices++;
-            }
+            tuningFile = sclFile;
+            requestSaveState();
         }
         
-        // Adjust performance mode based on active voices
-        if (activeVoices > 8 && performanceMode < 2)
-        {
-            setPerformanceMode(performanceMode + 1);
-            DBG("Performance mode increased to: " << performanceMode);
-        }
-        else if (activeVoices <= 4 && performanceMode > 0)
-        {
-            setPerformanceMode(performanceMode - 1);
-            DBG("Performance mode decreased to: " << performanceMode);
-        }
-    }
+        juce::AlertWindow::showMessageBoxAsync(
+            result.wasOk() ? juce::AlertWindow::InfoIcon : juce::AlertWindow::WarningIcon,
+            "Tuning",
+            result.wasOk() ? Tuning::inst().getDescription() : result.getErrorMessage(),
+            "OK"
+        );
+    });
 }
 
-void MainComponent::setPerformanceMode(int mode)
+// Performance optimization methods
+void MainComponent::adjustPerformanceSettings(int numSamples)
 {
-    performanceMode = juce::jlimit(0, 2, mode);
+    // Tier from the measured callback load, with hysteresis (see QualityController)
+    const int tier = qualityController.update(numSamples);
     
-    // Apply performance optimizations based on mode
-    switch (performanceMode)
+    if (tier != performanceMode)
     {
-        case 0: // Normal mode - full quality
-            // No optimizations needed
-            break;
-            
-        case 1: // Reduced mode - reduce unison count and chorus depth
-            // Reduce unison count to 4 oscillators
-            // Note: STK synthesizer doesn't have oscillator count setting
-            // Reduce chorus depth
-            smoothedChorusDepth.setTargetValue(0.2f);
-            break;
-            
-        case 2: // Minimal mode - further reductions
-            // Reduce unison count to 2 oscillators
-            // Note: STK synthesizer doesn't have oscillator count setting
-            // Further reduce chorus depth
-            smoothedChorusDepth.setTargetValue(0.1f);
-            // Reduce reverb wet level
-            smoothedReverbWet.setTargetValue(0.2f);
-            break;
+        setPerformanceMode(tier);
+        DBG("Performance mode changed to: " << performanceMode << " (load " << qualityController.getLoad() << ")");
     }
 }
 
+void MainComponent::setPerformanceMode(int mode)
+{
+    performanceMode = juce::jlimit(0, QualityController::kNumTiers - 1, mode);
+    
+    // The voices pick the tier up themselves: unison count, oversampling, filter
+    // control rate and the voice limit
+    ParameterHolder::inst().qualityTier.store(performanceMode);
+    
+    // Reverb and chorus fade out (or back in) rather than switching
+    effectsReturn.setTargetValue(QualityController::getTier(performanceMode).effectsEnabled ? effectsReturnLevel : 0.0f);
+}
+
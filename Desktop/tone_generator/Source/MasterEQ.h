@@ -0,0 +1,460 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <complex>
+#include <vector>
+#include "FilterTables.h"
+
+// Four-band master EQ (low shelf, two peaks, high shelf) with two engines that share
+// one set of RBJ band curves:
+//  - live: a zero-latency biquad cascade, left and right running together in the
+//    lanes of one SIMD register (flat bands are skipped entirely)
+//  - linear phase: the same magnitude response as a symmetric FIR, run through
+//    juce::dsp::Convolution (uniform partitioned FFT). The FIR is redesigned on a
+//    background thread whenever a band moves and handed to the audio thread through
+//    a try-locked slot; the convolution crossfades between impulse responses itself.
+//    Costs half the FIR length in latency, so it is only used for mastering/bounces.
+// setNonRealtime(true) selects the linear-phase engine regardless of the mode, so
+// offline renders always get it. Switching engines crossfades over one block, once the
+// incoming engine has settled.
+class MasterEQ
+{
+public:
+    using Vec = juce::dsp::SIMDRegister<float>;
+
+    static constexpr int kNumBands = 4;
+
+    enum class BandType { lowShelf, peak, highShelf };
+    enum class Mode { live, linearPhase };
+
+    // Band shapes are fixed; frequency and Q start here until setBand() moves them
+    struct BandDefaults
+    {
+        BandType type;
+        float frequency;
+        float q;
+    };
+
+    static constexpr std::array<BandDefaults, kNumBands> kDefaultBands { {
+        { BandType::lowShelf,  120.0f,  0.707f },
+        { BandType::peak,      500.0f,  0.9f },
+        { BandType::peak,      2500.0f, 0.9f },
+        { BandType::highShelf, 8000.0f, 0.707f }
+    } };
+
+    MasterEQ()
+    {
+        for (int band = 0; band < kNumBands; ++band)
+        {
+            const auto& defaults = kDefaultBands[static_cast<size_t>(band)];
+            bands[static_cast<size_t>(band)].frequency.store(defaults.frequency);
+            bands[static_cast<size_t>(band)].q.store(defaults.q);
+        }
+    }
+
+    ~MasterEQ() { designer.stopThread(2000); }
+
+    // Message thread - allocates, designs the first FIR and (re)starts the designer
+    void prepare(const juce::dsp::ProcessSpec& spec)
+    {
+        designer.stopThread(2000);
+
+        sampleRate = spec.sampleRate;
+        maxBlockSize = static_cast<int>(spec.maximumBlockSize);
+        numChannels = juce::jlimit(1, 2, static_cast<int>(spec.numChannels));
+        CutoffTable::prepare();
+
+        // ~80 ms of FIR keeps shelves down to ~100 Hz reasonably shaped at any rate
+        firLength = juce::jlimit(1024, 16384, juce::nextPowerOfTwo(static_cast<int>(sampleRate * 0.08)));
+
+        scratchBuffer.setSize(numChannels, maxBlockSize);
+
+        // Queued before prepare(), which installs it synchronously - an offline render
+        // starting right away is linear phase from its first sample
+        appliedVersion = settingsVersion.load() - 1; // recompute the cascade on the next block
+        designedVersion = settingsVersion.load();
+        convolution.loadImpulseResponse(designFir(), sampleRate, juce::dsp::Convolution::Stereo::no,
+                                        juce::dsp::Convolution::Trim::no, juce::dsp::Convolution::Normalise::no);
+        convolution.prepare({ sampleRate, static_cast<juce::uint32>(maxBlockSize), static_cast<juce::uint32>(numChannels) });
+
+        reset();
+        usingLinearPhase = wantsLinearPhase();
+        warmSamples = firLength; // from silence, the empty history is already the right one
+        designer.startThread(juce::Thread::Priority::low);
+    }
+
+    void reset() noexcept
+    {
+        for (auto& section : sections)
+            section.z1 = section.z2 = Vec::expand(0.0f);
+        convolution.reset();
+    }
+
+    // Any thread. Only bumps the settings version (and so a redesign) when something moved.
+    void setBand(int band, float frequencyHz, float gainDb, float q) noexcept
+    {
+        auto& settings = bands[static_cast<size_t>(band)];
+        if (settings.frequency.load() == frequencyHz && settings.gain.load() == gainDb && settings.q.load() == q)
+            return;
+
+        settings.frequency.store(frequencyHz);
+        settings.gain.store(gainDb);
+        settings.q.store(q);
+        ++settingsVersion;
+    }
+
+    void setBandGain(int band, float gainDb) noexcept
+    {
+        const auto& settings = bands[static_cast<size_t>(band)];
+        setBand(band, settings.frequency.load(), gainDb, settings.q.load());
+    }
+
+    void setMode(Mode newMode) noexcept { mode.store(newMode); }
+    Mode getMode() const noexcept       { return mode.load(); }
+
+    // Offline renders can afford the latency, so they always take the linear-phase engine
+    void setNonRealtime(bool isNonRealtime) noexcept { nonRealtime.store(isNonRealtime); }
+
+    bool wantsLinearPhase() const noexcept { return nonRealtime.load() || mode.load() == Mode::linearPhase; }
+
+    // Latency of the engine that has been asked for (the FIR's group delay, or none)
+    int getLatencySamples() const noexcept { return wantsLinearPhase() ? firLength / 2 : 0; }
+
+    // Audio thread - filters the first one or two channels of the range in place
+    void process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+    {
+        collectPendingFir();
+
+        if (appliedVersion != settingsVersion.load())
+            updateSections();
+
+        const int channels = juce::jmin(numChannels, buffer.getNumChannels());
+
+        for (int start = 0; start < numSamples; start += maxBlockSize)
+        {
+            const int count = juce::jmin(maxBlockSize, numSamples - start);
+
+            float* chunk[2] {};
+            for (int ch = 0; ch < channels; ++ch)
+                chunk[ch] = buffer.getWritePointer(ch, startSample + start);
+
+            processChunk(chunk, channels, count);
+        }
+    }
+
+private:
+    struct BandSettings
+    {
+        std::atomic<float> frequency { 1000.0f };
+        std::atomic<float> gain { 0.0f };  // dB
+        std::atomic<float> q { 0.707f };
+    };
+
+    struct Coefficients
+    {
+        float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+    };
+
+    struct Section
+    {
+        Vec b0 = Vec::expand(1.0f), b1 = Vec::expand(0.0f), b2 = Vec::expand(0.0f);
+        Vec a1 = Vec::expand(0.0f), a2 = Vec::expand(0.0f);
+        Vec z1 = Vec::expand(0.0f), z2 = Vec::expand(0.0f);
+    };
+
+    // RBJ cookbook shelf/peak, normalised by a0. Takes sin(w0) and 1 - cos(w0) so the
+    // audio thread can feed it from CutoffTable and the FIR designer from exact values.
+    static Coefficients designBand(BandType type, float gainDb, float q, float sinW0, float oneMinusCosW0) noexcept
+    {
+        const float a = std::pow(10.0f, gainDb / 40.0f);
+        const float cosW0 = 1.0f - oneMinusCosW0;
+        const float alpha = sinW0 / (2.0f * juce::jmax(0.1f, q));
+
+        float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a0 = 1.0f, a1 = 0.0f, a2 = 0.0f;
+
+        if (type == BandType::peak)
+        {
+            b0 = 1.0f + alpha * a;
+            b1 = -2.0f * cosW0;
+            b2 = 1.0f - alpha * a;
+            a0 = 1.0f + alpha / a;
+            a1 = -2.0f * cosW0;
+            a2 = 1.0f - alpha / a;
+        }
+        else
+        {
+            const float twoRootAAlpha = 2.0f * std::sqrt(a) * alpha;
+            const float sign = type == BandType::lowShelf ? 1.0f : -1.0f;
+
+            b0 = a * ((a + 1.0f) - sign * (a - 1.0f) * cosW0 + twoRootAAlpha);
+            b1 = sign * 2.0f * a * ((a - 1.0f) - sign * (a + 1.0f) * cosW0);
+            b2 = a * ((a + 1.0f) - sign * (a - 1.0f) * cosW0 - twoRootAAlpha);
+            a0 = (a + 1.0f) + sign * (a - 1.0f) * cosW0 + twoRootAAlpha;
+            a1 = -sign * 2.0f * ((a - 1.0f) + sign * (a + 1.0f) * cosW0);
+            a2 = (a + 1.0f) + sign * (a - 1.0f) * cosW0 - twoRootAAlpha;
+        }
+
+        const float a0Inverse = 1.0f / a0;
+        return { b0 * a0Inverse, b1 * a0Inverse, b2 * a0Inverse, a1 * a0Inverse, a2 * a0Inverse };
+    }
+
+    float clampedNormalisedFrequency(int band) const noexcept
+    {
+        const float frequency = bands[static_cast<size_t>(band)].frequency.load();
+        return juce::jlimit(CutoffTable::kMinNormalisedFrequency, CutoffTable::kMaxNormalisedFrequency,
+                            static_cast<float>(frequency / sampleRate));
+    }
+
+    // Control rate: rebuild the live cascade from the current band settings
+    void updateSections() noexcept
+    {
+        appliedVersion = settingsVersion.load();
+        numActiveSections = 0;
+
+        for (int band = 0; band < kNumBands; ++band)
+        {
+            const auto& settings = bands[static_cast<size_t>(band)];
+            const float gainDb = settings.gain.load();
+            if (gainDb == 0.0f)
+                continue; // a flat band is an identity section
+
+            float sinW0 = 0.0f, oneMinusCosW0 = 0.0f;
+            CutoffTable::biquadTerms(clampedNormalisedFrequency(band), sinW0, oneMinusCosW0);
+            const auto c = designBand(kDefaultBands[static_cast<size_t>(band)].type, gainDb, settings.q.load(), sinW0, oneMinusCosW0);
+
+            // Sections keep their state across coefficient changes; only the order is packed
+            auto& section = sections[static_cast<size_t>(numActiveSections++)];
+            section.b0 = Vec::expand(c.b0);
+            section.b1 = Vec::expand(c.b1);
+            section.b2 = Vec::expand(c.b2);
+            section.a1 = Vec::expand(c.a1);
+            section.a2 = Vec::expand(c.a2);
+        }
+    }
+
+    void processCascade(float* const* channels, int numChannelsToProcess, int numSamples) noexcept
+    {
+        if (numActiveSections == 0)
+            return;
+
+        alignas(Vec::SIMDRegisterSize) float lanes[Vec::SIMDNumElements] {};
+        float* left = channels[0];
+        float* right = numChannelsToProcess > 1 ? channels[1] : channels[0];
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            lanes[0] = left[i];
+            lanes[1] = right[i];
+            auto x = Vec::fromRawArray(lanes);
+
+            for (int s = 0; s < numActiveSections; ++s)
+            {
+                auto& section = sections[static_cast<size_t>(s)];
+                const auto y = section.b0 * x + section.z1;
+                section.z1 = section.b1 * x - section.a1 * y + section.z2;
+                section.z2 = section.b2 * x - section.a2 * y;
+                x = y;
+            }
+
+            x.copyToRawArray(lanes);
+            left[i] = lanes[0];
+            if (numChannelsToProcess > 1)
+                right[i] = lanes[1];
+        }
+    }
+
+    void processConvolution(float* const* channels, int numChannelsToProcess, int numSamples) noexcept
+    {
+        juce::dsp::AudioBlock<float> block(channels, static_cast<size_t>(numChannelsToProcess), static_cast<size_t>(numSamples));
+        convolution.process(juce::dsp::ProcessContextReplacing<float>(block));
+    }
+
+    float* const* copyToScratch(float* const* channels, int numChannelsToProcess, int numSamples) noexcept
+    {
+        for (int ch = 0; ch < numChannelsToProcess; ++ch)
+        {
+            scratchChannels[ch] = scratchBuffer.getWritePointer(ch);
+            juce::FloatVectorOperations::copy(scratchChannels[ch], channels[ch], numSamples);
+        }
+        return scratchChannels;
+    }
+
+    // Both engines keep their state warm on a copy of the input while the other one is
+    // audible, so a switch is a plain crossfade between two settled outputs. The FIR
+    // has to see a full length of signal before it may take over.
+    void processChunk(float* const* channels, int numChannelsToProcess, int numSamples) noexcept
+    {
+        const bool wantLinear = wantsLinearPhase();
+        if (! wantLinear)
+            warmSamples = 0;
+
+        const bool linear = wantLinear && convolution.getCurrentIRSize() == firLength && warmSamples >= firLength;
+
+        if (linear == usingLinearPhase)
+        {
+            if (linear)
+            {
+                processCascade(copyToScratch(channels, numChannelsToProcess, numSamples), numChannelsToProcess, numSamples);
+                processConvolution(channels, numChannelsToProcess, numSamples);
+            }
+            else
+            {
+                if (wantLinear)
+                {
+                    processConvolution(copyToScratch(channels, numChannelsToProcess, numSamples), numChannelsToProcess, numSamples);
+                    warmSamples += numSamples;
+                }
+                processCascade(channels, numChannelsToProcess, numSamples);
+            }
+            return;
+        }
+
+        // Engine switch: channels carries the outgoing engine, the scratch copy the incoming one
+        usingLinearPhase = linear;
+        auto* incoming = copyToScratch(channels, numChannelsToProcess, numSamples);
+
+        if (linear)
+        {
+            processCascade(channels, numChannelsToProcess, numSamples);
+            processConvolution(incoming, numChannelsToProcess, numSamples);
+        }
+        else
+        {
+            processConvolution(channels, numChannelsToProcess, numSamples);
+            processCascade(incoming, numChannelsToProcess, numSamples);
+        }
+
+        const float step = 1.0f / static_cast<float>(numSamples);
+        for (int ch = 0; ch < numChannelsToProcess; ++ch)
+        {
+            float* out = channels[ch];
+            const float* in = incoming[ch];
+            for (int i = 0; i < numSamples; ++i)
+                out[i] += static_cast<float>(i + 1) * step * (in[i] - out[i]);
+        }
+    }
+
+    // Audio thread: hand a finished FIR to the convolution without ever waiting on the designer
+    void collectPendingFir() noexcept
+    {
+        const juce::SpinLock::ScopedTryLockType lock(pendingLock);
+        if (! lock.isLocked() || ! firPending)
+            return;
+
+        firPending = false;
+        convolution.loadImpulseResponse(std::move(pendingFir), sampleRate, juce::dsp::Convolution::Stereo::no,
+                                        juce::dsp::Convolution::Trim::no, juce::dsp::Convolution::Normalise::no);
+    }
+
+    // Background thread (and prepare): linear-phase FIR with the cascade's magnitude response.
+    // The zero-phase spectrum is delayed by half the length, inverse transformed and Hann windowed,
+    // which leaves a symmetric impulse response centred on firLength / 2.
+    juce::AudioBuffer<float> designFir() const
+    {
+        const int order = juce::roundToInt(std::log2(static_cast<double>(firLength)));
+        juce::dsp::FFT fft(order);
+        std::vector<float> spectrum(static_cast<size_t>(firLength * 2), 0.0f);
+
+        std::array<Coefficients, kNumBands> curves {};
+        std::array<bool, kNumBands> flat {};
+        for (int band = 0; band < kNumBands; ++band)
+        {
+            const auto& settings = bands[static_cast<size_t>(band)];
+            const float gainDb = settings.gain.load();
+            flat[static_cast<size_t>(band)] = gainDb == 0.0f;
+
+            const double w0 = juce::MathConstants<double>::twoPi * clampedNormalisedFrequency(band);
+            curves[static_cast<size_t>(band)] = designBand(kDefaultBands[static_cast<size_t>(band)].type, gainDb, settings.q.load(),
+                                                           static_cast<float>(std::sin(w0)), static_cast<float>(1.0 - std::cos(w0)));
+        }
+
+        for (int bin = 0; bin <= firLength / 2; ++bin)
+        {
+            const double w = juce::MathConstants<double>::twoPi * bin / firLength;
+            const std::complex<double> z1 = std::polar(1.0, -w), z2 = std::polar(1.0, -2.0 * w);
+
+            double magnitude = 1.0;
+            for (int band = 0; band < kNumBands; ++band)
+            {
+                if (flat[static_cast<size_t>(band)])
+                    continue;
+
+                const auto& c = curves[static_cast<size_t>(band)];
+                magnitude *= std::abs((static_cast<double>(c.b0) + static_cast<double>(c.b1) * z1 + static_cast<double>(c.b2) * z2)
+                                      / (1.0 + static_cast<double>(c.a1) * z1 + static_cast<double>(c.a2) * z2));
+            }
+
+            // e^(-j w N/2) is just +-1 on the FFT grid
+            spectrum[static_cast<size_t>(bin * 2)] = static_cast<float>((bin & 1) != 0 ? -magnitude : magnitude);
+        }
+
+        fft.performRealOnlyInverseTransform(spectrum.data());
+
+        juce::AudioBuffer<float> fir(1, firLength);
+        auto* taps = fir.getWritePointer(0);
+        for (int n = 0; n < firLength; ++n)
+        {
+            const double window = 0.5 - 0.5 * std::cos(juce::MathConstants<double>::twoPi * n / firLength);
+            taps[n] = static_cast<float>(spectrum[static_cast<size_t>(n)] * window);
+        }
+        return fir;
+    }
+
+    class FirDesigner : public juce::Thread
+    {
+    public:
+        explicit FirDesigner(MasterEQ& eq) : juce::Thread("Master EQ FIR designer"), owner(eq) {}
+
+        void run() override
+        {
+            while (! threadShouldExit())
+            {
+                const auto version = owner.settingsVersion.load();
+                if (version != owner.designedVersion)
+                {
+                    owner.designedVersion = version;
+                    auto fir = owner.designFir();
+
+                    const juce::SpinLock::ScopedLockType lock(owner.pendingLock);
+                    owner.pendingFir = std::move(fir); // replaces (and frees) any FIR the audio thread never took
+                    owner.firPending = true;
+                }
+
+                wait(20);
+            }
+        }
+
+    private:
+        MasterEQ& owner;
+    };
+
+    std::array<BandSettings, kNumBands> bands;
+    std::atomic<juce::uint32> settingsVersion { 0 };
+
+    double sampleRate = 44100.0;
+    int maxBlockSize = 512;
+    int numChannels = 2;
+    int firLength = 4096;
+    std::atomic<Mode> mode { Mode::live };
+    std::atomic<bool> nonRealtime { false };
+    bool usingLinearPhase = false;
+
+    // Live engine (audio thread only)
+    std::array<Section, kNumBands> sections;
+    int numActiveSections = 0;
+    juce::uint32 appliedVersion = 0;
+
+    // Linear-phase engine
+    juce::dsp::Convolution convolution;
+    juce::AudioBuffer<float> scratchBuffer;
+    float* scratchChannels[2] {};
+    int warmSamples = 0;
+    juce::uint32 designedVersion = 0; // designer thread only (after prepare)
+    juce::SpinLock pendingLock;
+    juce::AudioBuffer<float> pendingFir;
+    bool firPending = false;
+    FirDesigner designer { *this };
+};
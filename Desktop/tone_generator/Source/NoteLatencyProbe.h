@@ -0,0 +1,123 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <functional>
+
+// Touch-to-sound latency of the note buttons, one note at a time:
+//  - buttonPressed() when the press arrives (message thread)
+//  - aboutToSendNoteOn() just before keyboardState.noteOn() (message thread), so no
+//    callback can pick the note up ahead of its timestamp
+//  - processBlock() after the synth has rendered each callback (audio thread) - finds the
+//    first non-zero sample of the output and dates it from the callback's start time
+// The audio thread only stores timestamps and flips an atomic; a timer on the message
+// thread picks the result up and hands it to onMeasurement. Any non-zero sample counts,
+// so only report notes that start from silence. Presses that arrive while a measurement
+// is in flight are ignored, and one that never sounds is dropped after kTimeoutSeconds.
+// The output device's own latency comes on top of the figures here.
+class NoteLatencyProbe : private juce::Timer
+{
+public:
+    static constexpr double kTimeoutSeconds = 2.0;
+    static constexpr int kPollIntervalMs = 100;
+
+    struct Measurement
+    {
+        int midiNote;
+        double pressToNoteOnMs;   // UI handling before the note reached the keyboard state
+        double noteOnToSoundMs;   // until the first non-zero sample was rendered
+        double totalMs() const noexcept { return pressToNoteOnMs + noteOnToSoundMs; }
+    };
+
+    std::function<void(const Measurement&)> onMeasurement;
+
+    ~NoteLatencyProbe() override { stopTimer(); }
+
+    // Message thread
+    void buttonPressed() noexcept
+    {
+        if (stage.load(std::memory_order_acquire) == idle)
+            pressTicks = juce::Time::getHighResolutionTicks();
+    }
+
+    void aboutToSendNoteOn(int midiNote) noexcept
+    {
+        if (stage.load(std::memory_order_acquire) != idle)
+            return;
+
+        noteOnTicks = juce::Time::getHighResolutionTicks();
+        pendingNote = midiNote;
+        stage.store(armed, std::memory_order_release);
+        startTimer(kPollIntervalMs);
+    }
+
+    // Audio thread, at the very start of the callback
+    void blockStarted() noexcept
+    {
+        if (stage.load(std::memory_order_relaxed) == armed)
+            blockStartTicks = juce::Time::getHighResolutionTicks();
+    }
+
+    // Audio thread, once the synth has rendered into the buffer
+    void processBlock(const juce::AudioBuffer<float>& buffer, int startSample, int numSamples, double sampleRate) noexcept
+    {
+        if (stage.load(std::memory_order_acquire) != armed || sampleRate <= 0.0)
+            return;
+
+        // A block that started before the note-on can't hold its first sample
+        if (blockStartTicks < noteOnTicks)
+            return;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            {
+                if (buffer.getSample(ch, startSample + i) != 0.0f)
+                {
+                    soundTicks = blockStartTicks + juce::Time::secondsToHighResolutionTicks(i / sampleRate);
+                    auto expected = static_cast<int>(armed);
+                    stage.compare_exchange_strong(expected, measured, std::memory_order_acq_rel);
+                    return;
+                }
+            }
+        }
+    }
+
+private:
+    enum Stage { idle, armed, measured };
+
+    void timerCallback() override
+    {
+        const auto current = stage.load(std::memory_order_acquire);
+
+        if (current == measured)
+        {
+            stopTimer();
+            const Measurement result { pendingNote,
+                                       juce::Time::highResolutionTicksToSeconds(noteOnTicks - pressTicks) * 1000.0,
+                                       juce::Time::highResolutionTicksToSeconds(soundTicks - noteOnTicks) * 1000.0 };
+            stage.store(idle, std::memory_order_release);
+
+            if (onMeasurement != nullptr)
+                onMeasurement(result);
+        }
+        else if (current == armed
+                 && juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - noteOnTicks) > kTimeoutSeconds)
+        {
+            // Never sounded (audio stopped, or the voice was silent) - give up on this one,
+            // unless a block got there first, in which case the next poll reports it
+            auto expected = static_cast<int>(armed);
+            if (stage.compare_exchange_strong(expected, idle, std::memory_order_acq_rel))
+                stopTimer();
+        }
+    }
+
+    std::atomic<int> stage { idle };
+
+    // Message thread while idle, read-only while armed
+    juce::int64 pressTicks = 0, noteOnTicks = 0;
+    int pendingNote = -1;
+
+    // Audio thread while armed, read by the timer once measured
+    juce::int64 blockStartTicks = 0, soundTicks = 0;
+};
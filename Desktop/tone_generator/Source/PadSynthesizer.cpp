@@ -8,208 +8,598 @@ PadSynthesizer::PadSynthesizer()
 
 void PadSynthesizer::prepare(double sampleRate, int samplesPerBlock)
 {
+    if (getNumVoices() == 0)
+    {
+        for (int i = 0; i < voiceCount; ++i)
+            addVoice(new PadVoice());
+        
+        addSound(new PadSound());
+    }
+    
     setCurrentPlaybackSampleRate(sampleRate);
     
+    const juce::ScopedLock sl(lock);
+    
+    // The one place voice types are checked - everything after this uses padVoices
+    padVoices.clear();
+    for (auto* voice : voices)
+    {
+        auto* padVoice = dynamic_cast<PadVoice*>(voice);
+        jassert(padVoice != nullptr); // PadSynthesizer only plays PadVoices
+        if (padVoice != nullptr)
+            padVoices.push_back(padVoice);
+    }
+    
     // Prepare all voices with the correct sample rate and block size
-    for (int i = 0; i < getNumVoices(); ++i)
+    for (auto* voice : padVoices)
+        voice->prepare(sampleRate, samplesPerBlock);
+    
+    // Voices still tailing off carry on under the new bookkeeping, with every setting applied
+    pullVoiceSettings();
+    allocator.prepare(static_cast<int>(padVoices.size()));
+    voiceSettingsApplied.assign(padVoices.size(), voiceSettings.version - 1);
+    for (int i = 0; i < static_cast<int>(padVoices.size()); ++i)
     {
-        if (auto* voice = dynamic_cast<PadVoice*>(getVoice(i)))
-        {
-            voice->prepare(sampleRate, samplesPerBlock);
-        }
+        catchUpVoiceSettings(i);
+        if (padVoices[static_cast<size_t>(i)]->isVoiceActive())
+            allocator.claim(i, padVoices[static_cast<size_t>(i)]->getCurrentlyPlayingNote());
     }
+    
+    arpeggiator.prepare(sampleRate);
+    arpeggiatorMidi.ensureSize(4096);
+    
+    // Two lanes per voice - left and right sit side by side in the same register
+    filterBank.prepare(sampleRate, 2 * getNumVoices(), PadVoice::kControlBlockSize);
+    gainScratch.assign(static_cast<size_t>(getNumVoices() * PadVoice::kControlBlockSize), 0.0f);
+    
+    updateVoiceStates();
 }
 
-// Note: We now use JUCE's built-in Synthesiser::renderNextBlock method
-// which automatically handles voice management and rendering
-
-void PadSynthesizer::setDetuneAmount(float detuneAmount)
+void PadSynthesizer::renderNextBlock(juce::AudioBuffer<float>& outputAudio, const juce::MidiBuffer& inputMidi, int startSample, int numSamples)
 {
-    for (int i = 0; i < getNumVoices(); ++i)
+    // Must set the sample rate before using this
+    jassert(getSampleRate() > 0.0);
+    
+    const juce::ScopedLock sl(lock);
+    const bool hasChannels = outputAudio.getNumChannels() > 0;
+    
+    // Queued chords start together at the top of the block
+    applyQueuedChords(true);
+    
+    // Arpeggiator steps join the incoming MIDI - as note events they split the block exactly
+    const juce::MidiBuffer* midi = &inputMidi;
+    if (arpeggiator.isRunning())
     {
-        if (auto* voice = dynamic_cast<PadVoice*>(getVoice(i)))
-        {
-            voice->setDetuneAmount(detuneAmount);
-        }
+        arpeggiatorMidi.clear();
+        arpeggiatorMidi.addEvents(inputMidi, 0, -1, 0);
+        arpeggiator.process(arpeggiatorMidi, startSample, numSamples);
+        midi = &arpeggiatorMidi;
     }
+    
+    scheduler.setControlInterval(PadVoice::kControlBlockSize);
+    scheduler.process(*midi, startSample, numSamples,
+        [&](int spanStart, int spanSamples) { if (hasChannels) renderVoices(outputAudio, spanStart, spanSamples); },
+        [&](const juce::MidiMessage& message) { handleMidiEvent(message); });
 }
 
-void PadSynthesizer::setOscillatorCount(int count)
+void PadSynthesizer::setMinimumRenderingSubdivisionSize(int numSamples, bool shouldBeStrict) noexcept
+{
+    juce::Synthesiser::setMinimumRenderingSubdivisionSize(numSamples, shouldBeStrict);
+    scheduler.setMinimumSubBlockSize(numSamples, shouldBeStrict);
+}
+
+void PadSynthesizer::setVoiceStealPolicy(VoiceAllocator::StealPolicy policy)
+{
+    const juce::ScopedLock sl(lock);
+    stealPolicy = policy;
+}
+
+// Note: We use JUCE's built-in Synthesiser::renderNextBlock for MIDI handling;
+// renderVoices below replaces the per-voice render loop
+void PadSynthesizer::renderVoices(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples)
 {
-    for (int i = 0; i < getNumVoices(); ++i)
+    // Parameter changes reach the voices here, once per block
+    pullVoiceSettings();
+    
+    const int numVoices = getNumVoices();
+    
+    // Not prepared for this many voices yet - let each voice render and filter itself
+    if (! isAllocatorReady() || 2 * numVoices > filterBank.getNumLanes() || numVoices * PadVoice::kControlBlockSize > static_cast<int>(gainScratch.size()))
+    {
+        juce::Synthesiser::renderVoices(outputAudio, startSample, numSamples);
+        return;
+    }
+    
+    juce::ScopedNoDenormals noDenormals;
+    const int stride = filterBank.getLaneStride();
+    
+    for (int offset = 0; offset < numSamples; offset += PadVoice::kControlBlockSize)
     {
-        if (auto* voice = dynamic_cast<PadVoice*>(getVoice(i)))
+        const int blockSamples = juce::jmin(PadVoice::kControlBlockSize, numSamples - offset);
+        
+        // Every active SVF voice writes its unfiltered stereo signal into its pair of lanes
+        for (int i = allocator.getOldest(); i != VoiceAllocator::none; i = allocator.getNextNewer(i))
+        {
+            auto* voice = padVoices[static_cast<size_t>(i)];
+            const bool inBank = voice->isVoiceActive() && voice->getFilterModel() == FILTER_MODEL_CLASSIC;
+            const int leftLane = 2 * i;
+            filterBank.setLaneEnabled(leftLane, inBank);
+            filterBank.setLaneEnabled(leftLane + 1, inBank);
+            
+            if (inBank)
+            {
+                voice->renderSource(filterBank.getLaneData(leftLane), filterBank.getLaneData(leftLane + 1), stride,
+                                    gainScratch.data() + i * PadVoice::kControlBlockSize, blockSamples,
+                                    filterBank.getModulationData(leftLane), filterBank.getModulationData(leftLane + 1));
+                filterBank.setLaneParameters(leftLane, voice->getControlCutoff(), voice->getControlResonance());
+                filterBank.setLaneParameters(leftLane + 1, voice->getControlCutoff(), voice->getControlResonance());
+                filterBank.setLaneModulationDepth(leftLane, voice->getFilterFMDepth());
+                filterBank.setLaneModulationDepth(leftLane + 1, voice->getFilterFMDepth());
+            }
+            else
+            {
+                // Ladder voices filter themselves
+                voice->renderNextBlock(outputAudio, startSample + offset, blockSamples);
+            }
+        }
+        
+        // One vector pass filters them all
+        filterBank.process(blockSamples);
+        
+        for (int i = allocator.getOldest(); i != VoiceAllocator::none; i = allocator.getNextNewer(i))
         {
-            voice->setOscillatorCount(count);
+            if (filterBank.isLaneEnabled(2 * i))
+                padVoices[static_cast<size_t>(i)]->renderFiltered(outputAudio, startSample + offset,
+                                                                  filterBank.getLaneData(2 * i), filterBank.getLaneData(2 * i + 1), stride,
+                                                                  gainScratch.data() + i * PadVoice::kControlBlockSize, blockSamples);
         }
+        
+        updateVoiceStates();
     }
 }
 
-void PadSynthesizer::setEnvelopeAttack(float attack)
+void PadSynthesizer::updateVoiceStates()
 {
-    for (int i = 0; i < getNumVoices(); ++i)
+    // Voices that have finished leave the active list (and the filter bank); the rest
+    // report whether they are releasing and how loud they are for the steal policy
+    for (int i = allocator.getOldest(); i != VoiceAllocator::none;)
     {
-        if (auto* voice = dynamic_cast<PadVoice*>(getVoice(i)))
+        const int next = allocator.getNextNewer(i);
+        auto* voice = padVoices[static_cast<size_t>(i)];
+        
+        if (! voice->isVoiceActive())
+        {
+            filterBank.setLaneEnabled(2 * i, false);
+            filterBank.setLaneEnabled(2 * i + 1, false);
+            allocator.retire(i);
+        }
+        else
         {
-            voice->setEnvelopeAttack(attack);
+            if (voice->isPlayingButReleased())
+                allocator.release(i);
+            
+            allocator.setLevel(i, voice->getCurrentLevel());
         }
+        
+        i = next;
     }
+    
+    numActiveVoices.store(allocator.getNumActive(), std::memory_order_relaxed);
 }
 
-void PadSynthesizer::setEnvelopeDecay(float decay)
+void PadSynthesizer::setVoiceSetting(VoiceSetting setting, float value)
+{
+    const juce::SpinLock::ScopedLockType sl(settingsWriteLock);
+    
+    nextVoiceSettings.values[static_cast<size_t>(setting)] = value;
+    nextVoiceSettings.sent.set(static_cast<size_t>(setting));
+    ++nextVoiceSettings.version;
+    
+    publishedVoiceSettings.getWriteBuffer() = nextVoiceSettings;
+    publishedVoiceSettings.publish();
+}
+
+void PadSynthesizer::pullVoiceSettings()
 {
-    for (int i = 0; i < getNumVoices(); ++i)
+    if (! publishedVoiceSettings.update())
+        return;
+    
+    const auto& next = publishedVoiceSettings.read();
+    
+    // What changed since the snapshot the voices were working from
+    auto changed = next.sent & ~voiceSettings.sent;
+    for (size_t setting = 0; setting < changed.size(); ++setting)
+        if (voiceSettings.sent.test(setting) && next.values[setting] != voiceSettings.values[setting])
+            changed.set(setting);
+    
+    const uint32_t previousVersion = voiceSettings.version;
+    voiceSettings = next;
+    
+    // Not prepared yet - prepare() hands every voice the settings
+    if (! isAllocatorReady())
+        return;
+    
+    for (int i = allocator.getOldest(); i != VoiceAllocator::none; i = allocator.getNextNewer(i))
     {
-        if (auto* voice = dynamic_cast<PadVoice*>(getVoice(i)))
+        // A voice that was up to date only needs the changes; any other catches up in full
+        auto& applied = voiceSettingsApplied[static_cast<size_t>(i)];
+        if (applied != previousVersion)
         {
-            voice->setEnvelopeDecay(decay);
+            catchUpVoiceSettings(i);
+            continue;
         }
+        
+        auto& voice = *padVoices[static_cast<size_t>(i)];
+        for (size_t setting = 0; setting < changed.size(); ++setting)
+            if (changed.test(setting))
+                applyVoiceSetting(voice, static_cast<VoiceSetting>(setting), voiceSettings.values[setting]);
+        
+        applied = voiceSettings.version;
     }
 }
 
-void PadSynthesizer::setEnvelopeSustain(float sustain)
+void PadSynthesizer::applyVoiceSetting(PadVoice& voice, VoiceSetting setting, float value)
 {
-    for (int i = 0; i < getNumVoices(); ++i)
+    switch (setting)
     {
-        if (auto* voice = dynamic_cast<PadVoice*>(getVoice(i)))
-        {
-            voice->setEnvelopeSustain(sustain);
-        }
+        case detuneSetting:                  voice.setDetuneAmount(value); break;
+        case oscillatorCountSetting:         voice.setOscillatorCount(static_cast<int>(value)); break;
+        case envelopeAttackSetting:          voice.setEnvelopeAttack(value); break;
+        case envelopeDecaySetting:           voice.setEnvelopeDecay(value); break;
+        case envelopeSustainSetting:         voice.setEnvelopeSustain(value); break;
+        case envelopeReleaseSetting:         voice.setEnvelopeRelease(value); break;
+        case filterCutoffSetting:            voice.setFilterCutoff(value); break;
+        case filterResonanceSetting:         voice.setFilterResonance(value); break;
+        case filterModelSetting:             voice.setFilterModel(static_cast<int>(value)); break;
+        case filterOversamplingSetting:      voice.setFilterOversampling(value != 0.0f); break;
+        case formantEnabledSetting:          voice.setFormantEnabled(value != 0.0f); break;
+        case filterFMSetting:                voice.setFilterFM(value); break;
+        case formantVowelSetting:            voice.setFormantVowel(value); break;
+        case resonatorCombSetting:           voice.setResonatorComb(value); break;
+        case resonatorDecaySetting:          voice.setResonatorDecay(value); break;
+        case resonatorDampingSetting:        voice.setResonatorDamping(value); break;
+        case resonatorAllpassSetting:        voice.setResonatorAllpass(value); break;
+        case filterEnvelopeAmountSetting:    voice.setFilterEnvelopeAmount(value); break;
+        case filterEnvelopeAttackSetting:    voice.setFilterEnvelopeAttack(value); break;
+        case filterEnvelopeDecaySetting:     voice.setFilterEnvelopeDecay(value); break;
+        case filterEnvelopeSustainSetting:   voice.setFilterEnvelopeSustain(value); break;
+        case filterEnvelopeReleaseSetting:   voice.setFilterEnvelopeRelease(value); break;
+        case filterLFODepthSetting:          voice.setFilterLFODepth(value); break;
+        case filterLFORateSetting:           voice.setFilterLFORate(value); break;
+        case pitchLFODepthSetting:           voice.setPitchLFODepth(value); break;
+        case pitchLFORateSetting:            voice.setPitchLFORate(value); break;
+        case glideModeSetting:               voice.setGlideMode(static_cast<GlideRamp::Mode>(static_cast<int>(value))); break;
+        case glideTimeSetting:               voice.setGlideTime(value); break;
+        case glideRateSetting:               voice.setGlideRate(value); break;
+        case silenceThresholdSetting:        voice.setSilenceThreshold(value); break;
+        case globalFrequencySetting:         voice.setGlobalFrequency(static_cast<double>(value)); break;
+        case waveformSetting:                voice.setWaveform(static_cast<int>(value)); break;
+        case numVoiceSettings:               break;
     }
 }
 
+void PadSynthesizer::catchUpVoiceSettings(int index)
+{
+    auto& applied = voiceSettingsApplied[static_cast<size_t>(index)];
+    if (applied == voiceSettings.version)
+        return;
+    
+    auto& voice = *padVoices[static_cast<size_t>(index)];
+    for (size_t setting = 0; setting < voiceSettings.sent.size(); ++setting)
+        if (voiceSettings.sent.test(setting))
+            applyVoiceSetting(voice, static_cast<VoiceSetting>(setting), voiceSettings.values[setting]);
+    
+    applied = voiceSettings.version;
+}
+
+void PadSynthesizer::setDetuneAmount(float detuneAmount)
+{
+    setVoiceSetting(detuneSetting, detuneAmount);
+}
+
+void PadSynthesizer::setOscillatorCount(int count)
+{
+    setVoiceSetting(oscillatorCountSetting, static_cast<float>(count));
+}
+
+void PadSynthesizer::setEnvelopeAttack(float attack)
+{
+    setVoiceSetting(envelopeAttackSetting, attack);
+}
+
+void PadSynthesizer::setEnvelopeDecay(float decay)
+{
+    setVoiceSetting(envelopeDecaySetting, decay);
+}
+
+void PadSynthesizer::setEnvelopeSustain(float sustain)
+{
+    setVoiceSetting(envelopeSustainSetting, sustain);
+}
+
 void PadSynthesizer::setEnvelopeRelease(float release)
 {
-    for (int i = 0; i < getNumVoices(); ++i)
-    {
-        if (auto* voice = dynamic_cast<PadVoice*>(getVoice(i)))
-        {
-            voice->setEnvelopeRelease(release);
-        }
-    }
+    setVoiceSetting(envelopeReleaseSetting, release);
 }
 
 void PadSynthesizer::setFilterCutoff(float cutoff)
 {
-    for (int i = 0; i < getNumVoices(); ++i)
-    {
-        if (auto* voice = dynamic_cast<PadVoice*>(getVoice(i)))
-        {
-            voice->setFilterCutoff(cutoff);
-        }
-    }
+    setVoiceSetting(filterCutoffSetting, cutoff);
 }
 
 void PadSynthesizer::setFilterResonance(float resonance)
 {
-    for (int i = 0; i < getNumVoices(); ++i)
-    {
-        if (auto* voice = dynamic_cast<PadVoice*>(getVoice(i)))
-        {
-            voice->setFilterResonance(resonance);
-        }
-    }
+    setVoiceSetting(filterResonanceSetting, resonance);
+}
+
+void PadSynthesizer::setFilterModel(int model)
+{
+    setVoiceSetting(filterModelSetting, static_cast<float>(model));
+}
+
+void PadSynthesizer::setFilterOversampling(bool shouldOversample)
+{
+    setVoiceSetting(filterOversamplingSetting, shouldOversample ? 1.0f : 0.0f);
+}
+
+void PadSynthesizer::setFormantEnabled(bool shouldBeEnabled)
+{
+    setVoiceSetting(formantEnabledSetting, shouldBeEnabled ? 1.0f : 0.0f);
+}
+
+void PadSynthesizer::setFilterFM(float amount)
+{
+    setVoiceSetting(filterFMSetting, amount);
+}
+
+void PadSynthesizer::setFormantVowel(float vowelPosition)
+{
+    setVoiceSetting(formantVowelSetting, vowelPosition);
+}
+
+void PadSynthesizer::setResonatorComb(float amount)
+{
+    setVoiceSetting(resonatorCombSetting, amount);
+}
+
+void PadSynthesizer::setResonatorDecay(float seconds)
+{
+    setVoiceSetting(resonatorDecaySetting, seconds);
+}
+
+void PadSynthesizer::setResonatorDamping(float damping)
+{
+    setVoiceSetting(resonatorDampingSetting, damping);
+}
+
+void PadSynthesizer::setResonatorAllpass(float depth)
+{
+    setVoiceSetting(resonatorAllpassSetting, depth);
 }
 
 // Filter envelope controls
 void PadSynthesizer::setFilterEnvelopeAmount(float amount)
 {
-    for (int i = 0; i < getNumVoices(); ++i)
-    {
-        if (auto* voice = dynamic_cast<PadVoice*>(getVoice(i)))
-        {
-            voice->setFilterEnvelopeAmount(amount);
-        }
-    }
+    setVoiceSetting(filterEnvelopeAmountSetting, amount);
 }
 
 void PadSynthesizer::setFilterEnvelopeAttack(float attack)
 {
-    for (int i = 0; i < getNumVoices(); ++i)
-    {
-        if (auto* voice = dynamic_cast<PadVoice*>(getVoice(i)))
-        {
-            voice->setFilterEnvelopeAttack(attack);
-        }
-    }
+    setVoiceSetting(filterEnvelopeAttackSetting, attack);
 }
 
 void PadSynthesizer::setFilterEnvelopeDecay(float decay)
 {
-    for (int i = 0; i < getNumVoices(); ++i)
-    {
-        if (auto* voice = dynamic_cast<PadVoice*>(getVoice(i)))
-        {
-            voice->setFilterEnvelopeDecay(decay);
-        }
-    }
+    setVoiceSetting(filterEnvelopeDecaySetting, decay);
 }
 
 void PadSynthesizer::setFilterEnvelopeSustain(float sustain)
 {
-    for (int i = 0; i < getNumVoices(); ++i)
-    {
-        if (auto* voice = dynamic_cast<PadVoice*>(getVoice(i)))
-        {
-            voice->setFilterEnvelopeSustain(sustain);
-        }
-    }
+    setVoiceSetting(filterEnvelopeSustainSetting, sustain);
 }
 
 void PadSynthesizer::setFilterEnvelopeRelease(float release)
 {
-    for (int i = 0; i < getNumVoices(); ++i)
-    {
-        if (auto* voice = dynamic_cast<PadVoice*>(getVoice(i)))
-        {
-            voice->setFilterEnvelopeRelease(release);
-        }
-    }
+    setVoiceSetting(filterEnvelopeReleaseSetting, release);
 }
 
 // LFO controls
 void PadSynthesizer::setFilterLFODepth(float depth)
 {
-    for (int i = 0; i < getNumVoices(); ++i)
+    setVoiceSetting(filterLFODepthSetting, depth);
+}
+
+void PadSynthesizer::setFilterLFORate(float rate)
+{
+    setVoiceSetting(filterLFORateSetting, rate);
+}
+
+void PadSynthesizer::setPitchLFODepth(float depth)
+{
+    setVoiceSetting(pitchLFODepthSetting, depth);
+}
+
+void PadSynthesizer::setPitchLFORate(float rate)
+{
+    setVoiceSetting(pitchLFORateSetting, rate);
+}
+
+void PadSynthesizer::setGlideMode(GlideRamp::Mode mode)
+{
+    setVoiceSetting(glideModeSetting, static_cast<float>(mode));
+}
+
+void PadSynthesizer::setGlideTime(float seconds)
+{
+    setVoiceSetting(glideTimeSetting, seconds);
+}
+
+void PadSynthesizer::setGlideRate(float semitonesPerSecond)
+{
+    setVoiceSetting(glideRateSetting, semitonesPerSecond);
+}
+
+void PadSynthesizer::setSilenceThreshold(float thresholdDb)
+{
+    setVoiceSetting(silenceThresholdSetting, thresholdDb);
+}
+
+void PadSynthesizer::setLegatoEnabled(bool shouldBeLegato)
+{
+    const juce::ScopedLock sl(lock);
+    legatoEnabled = shouldBeLegato;
+}
+
+void PadSynthesizer::noteOn(int midiChannel, int midiNoteNumber, float velocity)
+{
+    const juce::ScopedLock sl(lock);
+    
+    pushHeldNote(midiNoteNumber);
+    
+    // Not prepared yet - plain JUCE voice handling
+    if (! isAllocatorReady())
+    {
+        juce::Synthesiser::noteOn(midiChannel, midiNoteNumber, velocity);
+        lastNoteNumber = midiNoteNumber;
+        return;
+    }
+    
+    // Legato: retarget the sounding voice instead of starting a new one
+    if (legatoEnabled)
+    {
+        const int legatoVoice = findLegatoVoice(midiChannel);
+        if (legatoVoice != VoiceAllocator::none)
+        {
+            retargetVoice(legatoVoice, midiChannel, midiNoteNumber, velocity);
+            lastNoteNumber = midiNoteNumber;
+            return;
+        }
+    }
+    
+    for (auto* sound : sounds)
     {
-        if (auto* voice = dynamic_cast<PadVoice*>(getVoice(i)))
+        if (sound->appliesToNote(midiNoteNumber) && sound->appliesToChannel(midiChannel))
         {
-            voice->setFilterLFODepth(depth);
+            // If hitting a note that's still ringing, stop it first
+            for (int i = allocator.getFirstOnNote(midiNoteNumber); i != VoiceAllocator::none; i = allocator.getNextOnNote(i))
+            {
+                auto* voice = padVoices[static_cast<size_t>(i)];
+                if (voice->getCurrentlyPlayingNote() == midiNoteNumber && voice->isPlayingChannel(midiChannel))
+                {
+                    stopVoice(voice, 1.0f, true);
+                    allocator.release(i);
+                }
+            }
+            
+            // A free voice first (bringing it up to date with the settings it missed), else a stolen one
+            int index = allocator.popFree();
+            if (index != VoiceAllocator::none)
+            {
+                allocator.activate(index, midiNoteNumber);
+                catchUpVoiceSettings(index);
+            }
+            else if (isNoteStealingEnabled())
+            {
+                index = allocator.findVictim(stealPolicy, midiNoteNumber);
+                if (index != VoiceAllocator::none)
+                    allocator.reassign(index, midiNoteNumber);
+            }
+            
+            if (index != VoiceAllocator::none)
+            {
+                auto* voice = padVoices[static_cast<size_t>(index)];
+                voice->setGlideOrigin(lastNoteNumber);
+                startVoice(voice, sound, midiChannel, midiNoteNumber, velocity);
+            }
         }
     }
+    
+    lastNoteNumber = midiNoteNumber;
 }
 
-void PadSynthesizer::setFilterLFORate(float rate)
+void PadSynthesizer::noteOff(int midiChannel, int midiNoteNumber, float velocity, bool allowTailOff)
 {
-    for (int i = 0; i < getNumVoices(); ++i)
+    const juce::ScopedLock sl(lock);
+    
+    removeHeldNote(midiNoteNumber);
+    
+    // Legato: fall back to the most recent note still held rather than releasing
+    if (legatoEnabled && numHeldNotes > 0 && isAllocatorReady())
     {
-        if (auto* voice = dynamic_cast<PadVoice*>(getVoice(i)))
+        const int fallbackNote = heldNotes[static_cast<size_t>(numHeldNotes - 1)];
+        
+        for (int i = allocator.getFirstOnNote(midiNoteNumber); i != VoiceAllocator::none; i = allocator.getNextOnNote(i))
         {
-            voice->setFilterLFORate(rate);
+            auto* voice = padVoices[static_cast<size_t>(i)];
+            if (voice->getCurrentlyPlayingNote() == midiNoteNumber && voice->isPlayingChannel(midiChannel) && voice->isKeyDown())
+            {
+                retargetVoice(i, midiChannel, fallbackNote, voice->getCurrentVelocity());
+                lastNoteNumber = fallbackNote;
+                return;
+            }
         }
     }
+    
+    juce::Synthesiser::noteOff(midiChannel, midiNoteNumber, velocity, allowTailOff);
 }
 
-void PadSynthesizer::setPitchLFODepth(float depth)
+void PadSynthesizer::allNotesOff(int midiChannel, bool allowTailOff)
 {
-    for (int i = 0; i < getNumVoices(); ++i)
+    const juce::ScopedLock sl(lock);
+    numHeldNotes = 0;
+    
+    // Chords still queued are dropped, and the arpeggiator stops with its next block
+    applyQueuedChords(false);
+    arpeggiator.clearNotes();
+    juce::Synthesiser::allNotesOff(midiChannel, allowTailOff);
+}
+
+void PadSynthesizer::pushHeldNote(int midiNoteNumber)
+{
+    removeHeldNote(midiNoteNumber);
+    if (numHeldNotes < static_cast<int>(heldNotes.size()))
+        heldNotes[static_cast<size_t>(numHeldNotes++)] = midiNoteNumber;
+}
+
+void PadSynthesizer::removeHeldNote(int midiNoteNumber)
+{
+    for (int i = 0; i < numHeldNotes; ++i)
     {
-        if (auto* voice = dynamic_cast<PadVoice*>(getVoice(i)))
+        if (heldNotes[static_cast<size_t>(i)] == midiNoteNumber)
         {
-            voice->setPitchLFODepth(depth);
+            for (int j = i + 1; j < numHeldNotes; ++j)
+                heldNotes[static_cast<size_t>(j - 1)] = heldNotes[static_cast<size_t>(j)];
+            --numHeldNotes;
+            return;
         }
     }
 }
 
-void PadSynthesizer::setPitchLFORate(float rate)
+int PadSynthesizer::findLegatoVoice(int midiChannel) const
 {
-    for (int i = 0; i < getNumVoices(); ++i)
+    // Most recently started voice whose key is still held on this channel - the active
+    // list runs oldest first, so the last match wins
+    int legatoVoice = VoiceAllocator::none;
+    
+    for (int i = allocator.getOldest(); i != VoiceAllocator::none; i = allocator.getNextNewer(i))
     {
-        if (auto* voice = dynamic_cast<PadVoice*>(getVoice(i)))
-        {
-            voice->setPitchLFORate(rate);
-        }
+        const auto* voice = padVoices[static_cast<size_t>(i)];
+        if (voice->isVoiceActive() && voice->isKeyDown() && voice->isPlayingChannel(midiChannel))
+            legatoVoice = i;
     }
+    
+    return legatoVoice;
+}
+
+void PadSynthesizer::retargetVoice(int index, int midiChannel, int midiNoteNumber, float velocity)
+{
+    // startVoice() hard-stops the voice before restarting it; the pending
+    // legato transition turns that pair into a glide to the new note
+    auto& voice = *padVoices[static_cast<size_t>(index)];
+    juce::SynthesiserSound::Ptr sound = voice.getCurrentlyPlayingSound();
+    voice.beginLegatoTransition();
+    allocator.reassign(index, midiNoteNumber);
+    startVoice(&voice, sound.get(), midiChannel, midiNoteNumber, velocity);
 }
 
 void PadSynthesizer::triggerNote(int midiNoteNumber, float velocity)
@@ -228,62 +618,149 @@ void PadSynthesizer::releaseAllNotes()
     allNotesOff(1, true);
 }
 
+bool PadSynthesizer::triggerChord(const ChordTable::Chord& chord, float velocity)
+{
+    return queueChordEvent({ chord, velocity, false });
+}
+
+bool PadSynthesizer::triggerChord(int rootNote, ChordTable::Quality quality, int inversion, float velocity)
+{
+    return triggerChord(ChordTable::build(rootNote, quality, inversion), velocity);
+}
+
+bool PadSynthesizer::releaseChord(const ChordTable::Chord& chord)
+{
+    return queueChordEvent({ chord, 0.0f, true });
+}
+
 void PadSynthesizer::triggerChord(const std::vector<int>& midiNotes, float velocity)
 {
+    ChordTable::Chord chord;
     for (int note : midiNotes)
-    {
-        triggerNote(note, velocity);
-    }
+        if (chord.numNotes < ChordTable::kMaxNotes)
+            chord.notes[static_cast<size_t>(chord.numNotes++)] = note;
+    
+    triggerChord(chord, velocity);
 }
 
 void PadSynthesizer::triggerMajorChord(int rootNote, float velocity)
 {
-    std::vector<int> chord = {rootNote, rootNote + 4, rootNote + 7};
-    triggerChord(chord, velocity);
+    triggerChord(rootNote, ChordTable::Quality::major, 0, velocity);
 }
 
 void PadSynthesizer::triggerMinorChord(int rootNote, float velocity)
 {
-    std::vector<int> chord = {rootNote, rootNote + 3, rootNote + 7};
-    triggerChord(chord, velocity);
+    triggerChord(rootNote, ChordTable::Quality::minor, 0, velocity);
 }
 
 void PadSynthesizer::triggerSus2Chord(int rootNote, float velocity)
 {
-    std::vector<int> chord = {rootNote, rootNote + 2, rootNote + 7};
-    triggerChord(chord, velocity);
+    triggerChord(rootNote, ChordTable::Quality::sus2, 0, velocity);
 }
 
 void PadSynthesizer::triggerSus4Chord(int rootNote, float velocity)
 {
-    std::vector<int> chord = {rootNote, rootNote + 5, rootNote + 7};
-    triggerChord(chord, velocity);
+    triggerChord(rootNote, ChordTable::Quality::sus4, 0, velocity);
 }
 
-void PadSynthesizer::updateAllVoices()
+bool PadSynthesizer::queueChordEvent(const ChordEvent& event)
 {
-    // This method can be used to update all voices with current parameters
-    // Currently parameters are updated individually in the setter methods
+    const auto scope = chordFifo.write(1);
+    if (scope.blockSize1 + scope.blockSize2 == 0)
+        return false;
+    
+    chordQueue[static_cast<size_t>(scope.blockSize1 > 0 ? scope.startIndex1 : scope.startIndex2)] = event;
+    return true;
 }
 
-void PadSynthesizer::setGlobalFrequency(double frequencyHz)
+void PadSynthesizer::applyQueuedChords(bool play)
 {
-    for (int i = 0; i < getNumVoices(); ++i)
+    // Everything ready is taken in one go, played or (play == false) dropped. noteOn and
+    // noteOff only re-enter the lock the caller already holds.
+    const auto scope = chordFifo.read(chordFifo.getNumReady());
+    if (! play)
+        return;
+    
+    scope.forEach([this](int index)
     {
-        if (auto* voice = dynamic_cast<PadVoice*>(getVoice(i)))
+        const auto& event = chordQueue[static_cast<size_t>(index)];
+        const auto& chord = event.chord;
+        
+        // A release stops the chord whichever way it was started - the arpeggiator may have
+        // been switched on since - so its notes get their noteOffs in either mode
+        if (event.release)
         {
-            voice->setGlobalFrequency(frequencyHz);
+            if (arpeggiatorEnabled)
+                arpeggiator.clearNotes();
+            
+            for (int i = 0; i < chord.numNotes; ++i)
+                noteOff(1, chord.notes[static_cast<size_t>(i)], 1.0f, true);
+            return;
         }
-    }
+        
+        if (arpeggiatorEnabled)
+        {
+            arpeggiator.setNotes(chord, event.velocity);
+            return;
+        }
+        
+        for (int i = 0; i < chord.numNotes; ++i)
+            noteOn(1, chord.notes[static_cast<size_t>(i)], event.velocity);
+    });
+}
+
+void PadSynthesizer::setArpeggiatorEnabled(bool shouldBeEnabled)
+{
+    const juce::ScopedLock sl(lock);
+    arpeggiatorEnabled = shouldBeEnabled;
+    
+    // Turning it off stops the note it is playing; held chords aren't resumed
+    if (! shouldBeEnabled)
+        arpeggiator.clearNotes();
+}
+
+void PadSynthesizer::setArpeggiatorTempo(double beatsPerMinute)
+{
+    const juce::ScopedLock sl(lock);
+    arpeggiator.setTempo(beatsPerMinute);
+}
+
+void PadSynthesizer::setArpeggiatorStepsPerBeat(double stepsPerBeat)
+{
+    const juce::ScopedLock sl(lock);
+    arpeggiator.setStepsPerBeat(stepsPerBeat);
+}
+
+void PadSynthesizer::setArpeggiatorGate(float fractionOfStep)
+{
+    const juce::ScopedLock sl(lock);
+    arpeggiator.setGate(fractionOfStep);
+}
+
+void PadSynthesizer::setArpeggiatorPattern(Arpeggiator::Pattern pattern)
+{
+    const juce::ScopedLock sl(lock);
+    arpeggiator.setPattern(pattern);
+}
+
+void PadSynthesizer::setArpeggiatorOctaves(int numOctaves)
+{
+    const juce::ScopedLock sl(lock);
+    arpeggiator.setOctaves(numOctaves);
+}
+
+void PadSynthesizer::updateAllVoices()
+{
+    // This method can be used to update all voices with current parameters
+    // Currently parameters reach the voices through pullVoiceSettings()
+}
+
+void PadSynthesizer::setGlobalFrequency(double frequencyHz)
+{
+    setVoiceSetting(globalFrequencySetting, static_cast<float>(frequencyHz));
 }
 
 void PadSynthesizer::setGlobalWaveform(int waveformType)
 {
-    for (int i = 0; i < getNumVoices(); ++i)
-    {
-        if (auto* voice = dynamic_cast<PadVoice*>(getVoice(i)))
-        {
-            voice->setWaveform(waveformType);
-        }
-    }
+    setVoiceSetting(waveformSetting, static_cast<float>(waveformType));
 }
@@ -3,6 +3,13 @@
 #include <JuceHeader.h>
 #include "PadVoice.h"
 #include "PadSound.h"
+#include "SVFBank.h"
+#include "VoiceAllocator.h"
+#include "TripleBuffer.h"
+#include "SubBlockScheduler.h"
+#include "ChordTable.h"
+#include "Arpeggiator.h"
+#include <bitset>
 
 class PadSynthesizer : public juce::Synthesiser
 {
@@ -10,9 +17,26 @@ public:
     PadSynthesizer();
     ~PadSynthesizer() override = default;
     
+    // Adds the voices (and the sound) on first use, then prepares them - voices must be PadVoices
     void prepare(double sampleRate, int samplesPerBlock);
     
-    // Pad-specific controls
+    // Splits the block only at note events (see SubBlockScheduler) - controllers wait for
+    // the next control block boundary, so automation doesn't chop the voices' spans up
+    using juce::Synthesiser::renderNextBlock;
+    void renderNextBlock(juce::AudioBuffer<float>& outputAudio, const juce::MidiBuffer& inputMidi, int startSample, int numSamples);
+    
+    // The shortest span a note event may split off (1 = sample accurate)
+    void setMinimumRenderingSubdivisionSize(int numSamples, bool shouldBeStrict = false) noexcept;
+    
+    // Sounding voices, as of the last rendered control block
+    int getNumActiveVoices() const { return numActiveVoices.load(std::memory_order_relaxed); }
+    
+    // Which sounding voice a new note takes over once every voice is busy
+    void setVoiceStealPolicy(VoiceAllocator::StealPolicy policy);
+    
+    // Pad-specific controls - every per-voice setter below is constant time and only
+    // publishes a new settings snapshot, which the audio thread picks up at the start of
+    // its next block. Writers serialise on a spin lock; the audio thread never takes it.
     void setDetuneAmount(float detuneAmount);
     void setOscillatorCount(int count);
     void setEnvelopeAttack(float attack);
@@ -21,6 +45,15 @@ public:
     void setEnvelopeRelease(float release);
     void setFilterCutoff(float cutoff);
     void setFilterResonance(float resonance);
+    void setFilterModel(int model);
+    void setFilterOversampling(bool shouldOversample);
+    void setFilterFM(float amount);              // 0..1 audio-rate cutoff modulation
+    void setFormantEnabled(bool shouldBeEnabled);
+    void setFormantVowel(float vowelPosition);
+    void setResonatorComb(float amount);
+    void setResonatorDecay(float seconds);
+    void setResonatorDamping(float damping);
+    void setResonatorAllpass(float depth);
     
     // Filter envelope controls
     void setFilterEnvelopeAmount(float amount);
@@ -35,24 +68,163 @@ public:
     void setPitchLFODepth(float depth);
     void setPitchLFORate(float rate);
     
+    // Portamento / legato
+    void setGlideMode(GlideRamp::Mode mode);
+    void setGlideTime(float seconds);
+    void setGlideRate(float semitonesPerSecond);
+    void setLegatoEnabled(bool shouldBeLegato);
+    
+    // Voice retirement
+    void setSilenceThreshold(float thresholdDb);
+    
+    // Note handling - overridden for glide origins and legato voice reuse
+    void noteOn(int midiChannel, int midiNoteNumber, float velocity) override;
+    void noteOff(int midiChannel, int midiNoteNumber, float velocity, bool allowTailOff) override;
+    void allNotesOff(int midiChannel, bool allowTailOff) override;
+    
     // Note triggering
     void triggerNote(int midiNoteNumber, float velocity = 1.0f);
     void releaseNote(int midiNoteNumber);
     void releaseAllNotes();
     
-    // Chord presets
-    void triggerChord(const std::vector<int>& midiNotes, float velocity = 1.0f);
+    // Chords - each one is queued as a single event, lock free and without allocating, and
+    // the audio thread plays all of its notes together at the start of its next block
+    // (or hands them to the arpeggiator). False when the queue is full. Safe from one
+    // thread at a time, typically the message thread.
+    bool triggerChord(const ChordTable::Chord& chord, float velocity = 1.0f);
+    bool triggerChord(int rootNote, ChordTable::Quality quality, int inversion = 0, float velocity = 1.0f);
+    bool releaseChord(const ChordTable::Chord& chord);
+    void triggerChord(const std::vector<int>& midiNotes, float velocity = 1.0f); // first kMaxNotes notes
     void triggerMajorChord(int rootNote, float velocity = 1.0f);
     void triggerMinorChord(int rootNote, float velocity = 1.0f);
     void triggerSus2Chord(int rootNote, float velocity = 1.0f);
     void triggerSus4Chord(int rootNote, float velocity = 1.0f);
     
+    // Arpeggiator - while enabled, chords are stepped through instead of held
+    void setArpeggiatorEnabled(bool shouldBeEnabled);
+    void setArpeggiatorTempo(double beatsPerMinute);
+    void setArpeggiatorStepsPerBeat(double stepsPerBeat);
+    void setArpeggiatorGate(float fractionOfStep);
+    void setArpeggiatorPattern(Arpeggiator::Pattern pattern);
+    void setArpeggiatorOctaves(int numOctaves);
+    
     // Global controls
     void setGlobalFrequency(double frequencyHz);
     void setGlobalWaveform(int waveformType);
     
+protected:
+    // Renders voices a control block at a time with every voice's filter run in one SVFBank pass
+    void renderVoices(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples) override;
+    
 private:
     int voiceCount = 8;
     
+    // Voices in the synth's own order, statically typed, with the sounding ones tracked by
+    // the allocator - rendering and parameter changes only ever visit those
+    std::vector<PadVoice*> padVoices;
+    VoiceAllocator allocator;
+    SubBlockScheduler scheduler;
+    VoiceAllocator::StealPolicy stealPolicy = VoiceAllocator::StealPolicy::releasedFirst;
+    std::atomic<int> numActiveVoices { 0 };
+    
+    // Every per-voice setter goes through setVoiceSetting(), which writes the setting into
+    // an immutable snapshot and publishes it through a triple buffer. Under the synth lock
+    // (once per rendered block, and in prepare) pullVoiceSettings() takes the newest
+    // snapshot and sends what changed to the sounding voices; an idle voice catches up on
+    // whatever it missed when it next starts. Voice state is therefore only ever touched
+    // by whoever holds the lock.
+    enum VoiceSetting
+    {
+        detuneSetting,
+        oscillatorCountSetting,
+        envelopeAttackSetting,
+        envelopeDecaySetting,
+        envelopeSustainSetting,
+        envelopeReleaseSetting,
+        filterCutoffSetting,
+        filterResonanceSetting,
+        filterModelSetting,
+        filterOversamplingSetting,
+        formantEnabledSetting,
+        filterFMSetting,
+        formantVowelSetting,
+        resonatorCombSetting,
+        resonatorDecaySetting,
+        resonatorDampingSetting,
+        resonatorAllpassSetting,
+        filterEnvelopeAmountSetting,
+        filterEnvelopeAttackSetting,
+        filterEnvelopeDecaySetting,
+        filterEnvelopeSustainSetting,
+        filterEnvelopeReleaseSetting,
+        filterLFODepthSetting,
+        filterLFORateSetting,
+        pitchLFODepthSetting,
+        pitchLFORateSetting,
+        glideModeSetting,
+        glideTimeSetting,
+        glideRateSetting,
+        silenceThresholdSetting,
+        globalFrequencySetting,
+        waveformSetting,
+        numVoiceSettings
+    };
+    struct VoiceSettings
+    {
+        std::array<float, numVoiceSettings> values {};
+        std::bitset<numVoiceSettings> sent;  // settings that have been set at least once
+        uint32_t version = 0;
+    };
+    
+    // Writer side, guarded by settingsWriteLock
+    juce::SpinLock settingsWriteLock;
+    VoiceSettings nextVoiceSettings;
+    TripleBuffer<VoiceSettings> publishedVoiceSettings;
+    
+    // Lock side - the snapshot the voices are working from
+    VoiceSettings voiceSettings;
+    std::vector<uint32_t> voiceSettingsApplied; // per voice: version it last caught up to
+    
+    void setVoiceSetting(VoiceSetting setting, float value);
+    void pullVoiceSettings();
+    static void applyVoiceSetting(PadVoice& voice, VoiceSetting setting, float value);
+    void catchUpVoiceSettings(int index);
+    void updateVoiceStates();
+    bool isAllocatorReady() const { return allocator.getNumVoices() == voices.size() && static_cast<int>(padVoices.size()) == voices.size(); }
+    
+    // Polyphonic stereo filter - lanes 2i and 2i + 1 belong to voice i
+    SVFBank filterBank;
+    std::vector<float> gainScratch; // Per-voice output gains for one control block
+    
+    // Legato state - held notes in press order, most recent last
+    bool legatoEnabled = false;
+    std::array<int, 128> heldNotes {};
+    int numHeldNotes = 0;
+    int lastNoteNumber = -1;
+    
+    // Chord queue - written by the chord triggers, read by whoever holds the lock (the
+    // audio thread at the start of each block, or allNotesOff)
+    static constexpr int kChordQueueSize = 16;
+    struct ChordEvent
+    {
+        ChordTable::Chord chord;
+        float velocity = 0.0f;
+        bool release = false;
+    };
+    std::array<ChordEvent, kChordQueueSize> chordQueue;
+    juce::AbstractFifo chordFifo { kChordQueueSize };
+    bool queueChordEvent(const ChordEvent& event);
+    void applyQueuedChords(bool play);
+    
+    // Arpeggiator state is touched under the lock only; its steps are merged with the
+    // block's MIDI in arpeggiatorMidi (reserved in prepare) so they land sample accurately
+    Arpeggiator arpeggiator;
+    bool arpeggiatorEnabled = false;
+    juce::MidiBuffer arpeggiatorMidi;
+    
     void updateAllVoices();
+    void pushHeldNote(int midiNoteNumber);
+    void removeHeldNote(int midiNoteNumber);
+    int findLegatoVoice(int midiChannel) const;
+    void retargetVoice(int index, int midiChannel, int midiNoteNumber, float velocity);
 };
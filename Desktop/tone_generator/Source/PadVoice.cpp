@@ -3,6 +3,7 @@
 PadVoice::PadVoice()
 {
     // Initialize unison oscillators with detuning and panning
+    PanTable::prepare();
     initializeUnisonOscillators();
     
     // Initialize envelope for Lush Pad A preset with smoother curves
@@ -14,15 +15,8 @@ PadVoice::PadVoice()
     envelope.setParameters(envelopeParams);
     
     // Initialize envelope smoother for stable transitions
-    envelopeSmoother.reset(0.0f);
-    envelopeSmoother.setCurrentAndTargetValue(0.0f);
     lastEnvelopeLevel = 0.0f;
     
-    // Initialize filter for Lush Pad A preset
-    filter.setType(juce::dsp::StateVariableTPTFilterType::lowpass);
-    filter.setCutoffFrequency(1200.0f); // Lush Pad A: 1.2 kHz cutoff
-    filter.setResonance(0.6f); // Lush Pad A: Q 0.6
-    
     // Initialize filter envelope for movement
     filterEnvelopeParams.attack = 0.1f;   // Quick attack
     filterEnvelopeParams.decay = 0.3f;    // Medium decay
@@ -30,17 +24,12 @@ PadVoice::PadVoice()
     filterEnvelopeParams.release = 1.0f;  // Medium release
     filterEnvelope.setParameters(filterEnvelopeParams);
     
-    // Initialize LFOs
-    filterLFO.initialise([](float x) { return std::sin(x); }); // Sine wave LFO
-    pitchLFO.initialise([](float x) { return std::sin(x); });  // Sine wave LFO
-    
     // Initialize smoothed values for Lush Pad A preset
-    smoothedFilterCutoff.reset(1200.0f); // Lush Pad A: 1.2 kHz cutoff
-    smoothedFilterResonance.reset(0.6f); // Lush Pad A: Q 0.6
-    smoothedDetuneAmount.reset(0.1f);
-    smoothedFilterEnvelopeAmount.reset(100.0f); // Reduced envelope amount to prevent volume fluctuation
-    smoothedFilterLFODepth.reset(50.0f); // Reduced LFO depth to prevent volume fluctuation
-    smoothedPitchLFODepth.reset(1.0f); // Reduced pitch LFO depth
+    smoothing.setCurrentAndTargetValue(smoothedFilterCutoff, 1200.0f); // Lush Pad A: 1.2 kHz cutoff
+    smoothing.setCurrentAndTargetValue(smoothedFilterResonance, 0.6f); // Lush Pad A: Q 0.6
+    smoothing.setCurrentAndTargetValue(smoothedFilterEnvelopeAmount, 100.0f); // Reduced envelope amount to prevent volume fluctuation
+    smoothing.setCurrentAndTargetValue(smoothedFilterLFODepth, 50.0f); // Reduced LFO depth to prevent volume fluctuation
+    smoothing.setCurrentAndTargetValue(smoothedPitchLFODepth, 1.0f); // Reduced pitch LFO depth
 }
 
 bool PadVoice::canPlaySound(juce::SynthesiserSound* sound)
@@ -50,33 +39,61 @@ bool PadVoice::canPlaySound(juce::SynthesiserSound* sound)
 
 void PadVoice::startNote(int midiNoteNumber, float velocity, juce::SynthesiserSound* sound, int currentPitchWheelPosition)
 {
-    ignoreUnused(sound, currentPitchWheelPosition);
+    ignoreUnused(sound);
     
-    DBG("=== PadVoice::startNote called ===");
-    DBG("MIDI Note: " << midiNoteNumber << ", Velocity: " << velocity);
-    DBG("Frequency: " << juce::MidiMessage::getMidiNoteInHertz(midiNoteNumber) << " Hz");
+    const float previousFrequency = currentFrequency;
+    const int midiChannel = Tuning::getVoiceChannel(*this);
     
     currentVelocity = velocity;
-    currentFrequency = static_cast<float>(juce::MidiMessage::getMidiNoteInHertz(midiNoteNumber));
+    noteReleased = false;
+    silenceDetector.reset();
+    currentFrequency = Tuning::inst().getNoteFrequency(midiNoteNumber, midiChannel);
+    pitchWheelMoved(currentPitchWheelPosition);
+    
+    if (legatoTransitionPending)
+    {
+        // Legato: keep envelopes and phases running, just glide to the new pitch
+        legatoTransitionPending = false;
+        glide.start(CentsTable::ratioToCents(previousFrequency / currentFrequency) + glide.getCurrentOffset(), getSampleRate());
+        return;
+    }
+    
+    if (glideOriginNote >= 0 && glide.getMode() != GlideRamp::Mode::off)
+    {
+        const float originFrequency = Tuning::inst().getNoteFrequency(glideOriginNote, midiChannel);
+        glide.start(CentsTable::ratioToCents(originFrequency / currentFrequency), getSampleRate());
+    }
+    else
+    {
+        glide.reset();
+    }
     
-    updateOscillatorFrequencies();
+    // Nothing else to derive here: the detune ratios are cached and the note frequency is
+    // folded in by updatePitchModulation() at the first control block
     
     // Start envelopes
     envelope.noteOn();
     filterEnvelope.noteOn();
     isActive = true;
-    
-    DBG("Voice activated - isActive: " << (isActive ? "true" : "false"));
 }
 
 void PadVoice::stopNote(float velocity, bool allowTailOff)
 {
     juce::ignoreUnused(velocity);
     
+    if (legatoTransitionPending && isActive)
+    {
+        // Hard stop issued by Synthesiser::startVoice during a legato handoff -
+        // release the note slot but keep the voice sounding for the retarget
+        clearCurrentNote();
+        return;
+    }
+    
     if (allowTailOff)
     {
         envelope.noteOff();
         filterEnvelope.noteOff();
+        noteReleased = true;
     }
     else
     {
@@ -89,8 +106,38 @@ void PadVoice::stopNote(float velocity, bool allowTailOff)
 
 void PadVoice::pitchWheelMoved(int newPitchWheelValue)
 {
-    juce::ignoreUnused(newPitchWheelValue);
-    // Could implement pitch wheel functionality here
+    // 14-bit wheel, centre 8192 - picked up at the next control block
+    pitchBendCents = static_cast<float>(newPitchWheelValue - 8192) / 8192.0f * pitchBendRangeCents;
+}
+
+void PadVoice::setGlideMode(GlideRamp::Mode mode)
+{
+    glide.setMode(mode);
+}
+
+void PadVoice::setGlideTime(float seconds)
+{
+    glide.setGlideTime(seconds);
+}
+
+void PadVoice::setGlideRate(float semitonesPerSecond)
+{
+    glide.setGlideRate(semitonesPerSecond);
+}
+
+void PadVoice::setGlideOrigin(int midiNoteNumber)
+{
+    glideOriginNote = midiNoteNumber;
+}
+
+void PadVoice::beginLegatoTransition()
+{
+    legatoTransitionPending = true;
+}
+
+void PadVoice::setSilenceThreshold(float thresholdDb)
+{
+    silenceDetector.setThresholdDecibels(thresholdDb);
 }
 
 void PadVoice::controllerMoved(int controllerNumber, int newControllerValue)
@@ -116,75 +163,154 @@ void PadVoice::renderNextBlock(juce::AudioBuffer<float>& outputBuffer, int start
         DBG("Envelope active: " << (envelope.isActive() ? "true" : "false"));
     }
     
-    // Process each sample
-    for (int sample = 0; sample < numSamples; ++sample)
+    // Standalone path: same stages PadSynthesizer runs, with this voice's own filter in between
+    for (int offset = 0; offset < numSamples && isActive; offset += kControlBlockSize)
     {
-        // Generate unison oscillator output with detuning and panning
-        float mixedSample = processUnisonSample();
-        
-        // Calculate dynamic filter cutoff with envelope and LFO using smoothed values
-        float baseCutoff = smoothedFilterCutoff.getNextValue(); // Use smoothed cutoff
-        
-        // Add velocity mapping to cutoff for brightness expression
-        float velocityCutoffModulation = currentVelocity * 1500.0f; // vel * 1500 Hz
+        const int blockSamples = juce::jmin(kControlBlockSize, numSamples - offset);
+        float gains[kControlBlockSize];
         
-        // Re-enable filter envelope and LFO with minimal depth for stability
-        float envelopeModulation = 0.0f;
-        float lfoModulation = 0.0f;
-        
-        // Calculate filter envelope modulation (minimal depth for stability)
-        if (envelope.isActive()) {
-            float envelopeLevel = envelope.getNextSample();
-            envelopeModulation = envelopeLevel * smoothedFilterEnvelopeAmount.getNextValue() * 0.1f; // Minimal depth
+        if (filterModel == FILTER_MODEL_LADDER)
+        {
+            float left[kControlBlockSize];
+            float right[kControlBlockSize];
+            renderSource(left, right, 1, gains, blockSamples);
+            
+            ladder.setCutoffFrequencyHz(controlCutoff);
+            ladder.setResonance(LadderFilter::resonanceFromQ(controlResonance));
+            float* channels[] = { left, right };
+            ladder.process(channels, blockSamples);
+            
+            renderFiltered(outputBuffer, startSample + offset, left, right, 1, gains, blockSamples);
         }
-        
-        // Calculate filter LFO modulation (minimal depth for stability)
-        float lfoValue = filterLFO.processSample(0.0f);
-        lfoModulation = lfoValue * smoothedFilterLFODepth.getNextValue() * 0.05f; // Very minimal depth
-        
-        // Debug logging occasionally
-        static int debugCounter = 0;
-        if (++debugCounter % 2000 == 0) {
-            DBG("Filter modulation - EnvMod: " << envelopeModulation << ", LFOMod: " << lfoModulation << " (ENABLED - MINIMAL)");
+        else
+        {
+            const int stride = filter.getLaneStride();
+            renderSource(filter.getLaneData(0), filter.getLaneData(1), stride, gains, blockSamples,
+                         filter.getModulationData(0), filter.getModulationData(1));
+            
+            filter.setLaneParameters(0, controlCutoff, controlResonance);
+            filter.setLaneParameters(1, controlCutoff, controlResonance);
+            filter.setLaneModulationDepth(0, filterFMDepth);
+            filter.setLaneModulationDepth(1, filterFMDepth);
+            filter.process(blockSamples);
+            
+            renderFiltered(outputBuffer, startSample + offset, filter.getLaneData(0), filter.getLaneData(1), stride, gains, blockSamples);
         }
+    }
+}
+
+void PadVoice::renderSource(float* left, float* right, int stride, float* gains, int numSamples,
+                            float* leftModulation, float* rightModulation)
+{
+    jassert(numSamples <= kControlBlockSize);
+    
+    // Control-rate work: smoothing, pitch and filter modulation once per block
+    smoothing.process(numSamples);
+    updatePitchModulation(numSamples);
+    updateFilterModulation(numSamples);
+    
+    // Apply velocity mapping to gain for loudness expression
+    // Gain: gain *= 0.6 + 0.4 * velocity (0.6-1.0 range), scaled down for pad sound
+    const float velocityGain = (0.6f + 0.4f * currentVelocity) * 0.3f;
+    
+    float leftSum[kControlBlockSize];
+    float rightSum[kControlBlockSize];
+    float modulator[kControlBlockSize];
+    
+    for (int i = 0; i < numSamples; ++i)
+    {
+        // Generate unison oscillator output with detuning and panning
+        processUnisonSample(leftSum[i], rightSum[i], modulator[i]);
         
-        // Calculate final cutoff frequency with all modulations (minimal depth for stability)
-        float dynamicCutoff = juce::jlimit(100.0f, 8000.0f, 
-            baseCutoff + velocityCutoffModulation + envelopeModulation + lfoModulation);
-        filter.setCutoffFrequency(dynamicCutoff);
-        
-        // Update filter resonance with smoothed value
-        filter.setResonance(smoothedFilterResonance.getNextValue());
-        
-        // Apply filter
-        float filteredSample = filter.processSample(0, mixedSample);
-        
-        // Apply ADSR envelope with smoothing for stable transitions
-        float rawEnvelopeLevel = envelope.getNextSample();
-        
-        // Smooth envelope transitions to prevent tremolo and artifacts
-        envelopeSmoother.setTargetValue(rawEnvelopeLevel);
-        float envelopeLevel = envelopeSmoother.getNextValue();
-        
-        // Apply smoothed envelope
-        filteredSample *= envelopeLevel;
+        filterEnvelopeLevel = filterEnvelope.getNextSample();
         
-        // Apply velocity mapping to gain for loudness expression
-        // Gain: gain *= 0.6 + 0.4 * velocity (0.6-1.0 range)
-        float velocityGain = 0.6f + 0.4f * currentVelocity;
-        filteredSample *= velocityGain * 0.3f; // Scale down for pad sound
+        // Smooth envelope transitions to prevent tremolo and artifacts (one-pole,
+        // equivalent to retargeting a 30ms SmoothedValue every sample)
+        const float rawEnvelopeLevel = envelope.getNextSample();
+        lastEnvelopeLevel += (rawEnvelopeLevel - lastEnvelopeLevel) * envelopeSmoothingCoefficient;
         
-        // Add to output buffer for all channels
-        for (int channel = 0; channel < outputBuffer.getNumChannels(); ++channel)
+        gains[i] = lastEnvelopeLevel * velocityGain;
+    }
+    
+    // Vowel colour on the oscillator sum, ahead of the filter
+    if (formantEnabled)
+    {
+        formant.setVowel(smoothing.getValues(smoothedFormantVowel)[0]);
+        float* channels[] = { leftSum, rightSum };
+        formant.process(channels, numSamples);
+    }
+    
+    for (int i = 0; i < numSamples; ++i)
+    {
+        left[i * stride] = leftSum[i];
+        right[i * stride] = rightSum[i];
+    }
+    
+    if (filterFMDepth > 0.0f && leftModulation != nullptr && rightModulation != nullptr)
+    {
+        for (int i = 0; i < numSamples; ++i)
         {
-            outputBuffer.addSample(channel, startSample + sample, filteredSample);
+            leftModulation[i * stride] = modulator[i];
+            rightModulation[i * stride] = modulator[i];
         }
     }
+}
+
+void PadVoice::renderFiltered(juce::AudioBuffer<float>& outputBuffer, int startSample,
+                              const float* left, const float* right, int stride, const float* gains, int numSamples)
+{
+    float leftOutput[kControlBlockSize];
+    float rightOutput[kControlBlockSize];
+    for (int i = 0; i < numSamples; ++i)
+    {
+        leftOutput[i] = left[i * stride];
+        rightOutput[i] = right[i * stride];
+    }
+    
+    // Resonator insert between the filter and the amp envelope
+    if (resonator.isActive())
+    {
+        float* channels[] = { leftOutput, rightOutput };
+        resonator.process(channels, numSamples);
+    }
+    
+    juce::FloatVectorOperations::multiply(leftOutput, gains, numSamples);
+    juce::FloatVectorOperations::multiply(rightOutput, gains, numSamples);
+    
+    const auto leftRange = juce::FloatVectorOperations::findMinAndMax(leftOutput, numSamples);
+    const auto rightRange = juce::FloatVectorOperations::findMinAndMax(rightOutput, numSamples);
+    const float blockPeak = juce::jmax(juce::jmax(-leftRange.getStart(), leftRange.getEnd()),
+                                       juce::jmax(-rightRange.getStart(), rightRange.getEnd()));
+    
+    // Add to the output a block at a time
+    if (outputBuffer.getNumChannels() >= 2)
+    {
+        outputBuffer.addFrom(0, startSample, leftOutput, numSamples);
+        outputBuffer.addFrom(1, startSample, rightOutput, numSamples);
+    }
+    else if (outputBuffer.getNumChannels() == 1)
+    {
+        // Mono fallback - mix both channels
+        outputBuffer.addFrom(0, startSample, leftOutput, numSamples, 0.5f);
+        outputBuffer.addFrom(0, startSample, rightOutput, numSamples, 0.5f);
+    }
+    
+    // Finish when the envelope is done, or earlier once the release (and any
+    // filter ringing) has dropped below the silence threshold
+    const bool releasedAndSilent = noteReleased && silenceDetector.processBlock(blockPeak, numSamples);
     
-    // Check if envelope is finished
-    if (!envelope.isActive())
+    if (!envelope.isActive() || releasedAndSilent)
     {
         clearCurrentNote();
+        envelope.reset();
+        filterEnvelope.reset();
+        filter.reset();
+        ladder.reset();
+        formant.reset();
+        if (resonator.isActive())
+            resonator.reset(); // the next note starts with silent delay lines
+        lastEnvelopeLevel = 0.0f;
+        filterEnvelopeLevel = 0.0f;
         isActive = false;
     }
 }
@@ -192,7 +318,6 @@ void PadVoice::renderNextBlock(juce::AudioBuffer<float>& outputBuffer, int start
 void PadVoice::setDetuneAmount(float newDetuneAmount)
 {
     DBG("PadVoice::setDetuneAmount called with: " << newDetuneAmount);
-    smoothedDetuneAmount.setTargetValue(newDetuneAmount);
     detuneAmount = newDetuneAmount; // Also update raw value for immediate use
     if (isActive)
         updateOscillatorFrequencies();
@@ -230,12 +355,67 @@ void PadVoice::setEnvelopeRelease(float release)
 
 void PadVoice::setFilterCutoff(float cutoff)
 {
-    smoothedFilterCutoff.setTargetValue(cutoff);
+    smoothing.setTargetValue(smoothedFilterCutoff, cutoff);
 }
 
 void PadVoice::setFilterResonance(float resonance)
 {
-    smoothedFilterResonance.setTargetValue(resonance);
+    smoothing.setTargetValue(smoothedFilterResonance, resonance);
+}
+
+void PadVoice::setFilterModel(int model)
+{
+    const int newModel = juce::jlimit(0, NUM_FILTER_MODELS - 1, model);
+    if (newModel == filterModel)
+        return;
+    
+    // Start the newly selected model from silence
+    filterModel = newModel;
+    filter.reset();
+    ladder.reset();
+}
+
+void PadVoice::setFilterOversampling(bool shouldOversample)
+{
+    ladder.setOversampling(shouldOversample);
+}
+
+void PadVoice::setFormantEnabled(bool shouldBeEnabled)
+{
+    if (shouldBeEnabled && ! formantEnabled)
+        formant.reset();
+    
+    formantEnabled = shouldBeEnabled;
+}
+
+void PadVoice::setFilterFM(float amount)
+{
+    filterFMDepth = juce::jlimit(0.0f, 1.0f, amount) * SVFBank::kMaxModulationDepth;
+}
+
+void PadVoice::setResonatorComb(float amount)
+{
+    resonator.setCombAmount(amount);
+}
+
+void PadVoice::setResonatorDecay(float seconds)
+{
+    resonator.setDecayTime(seconds);
+}
+
+void PadVoice::setResonatorDamping(float damping)
+{
+    resonator.setDamping(damping);
+}
+
+void PadVoice::setResonatorAllpass(float depth)
+{
+    resonator.setAllpassDepth(depth);
+}
+
+void PadVoice::setFormantVowel(float vowelPosition)
+{
+    smoothing.setTargetValue(smoothedFormantVowel, juce::jlimit(0.0f, static_cast<float>(FormantFilter::numVowels - 1), vowelPosition));
 }
 
 void PadVoice::updateOscillatorFrequencies()
@@ -264,79 +444,61 @@ void PadVoice::setGlobalFrequency(double frequencyHz)
 
 void PadVoice::setWaveform(int waveformType)
 {
+    // Unison oscillators read the waveform directly in renderWaveform()
     currentWaveform = waveformType;
-    
-    // Update all unison oscillators with the new waveform
-    for (int i = 0; i < kOsc; ++i)
+}
+
+float PadVoice::renderWaveform(float phase01) const
+{
+    switch (currentWaveform)
     {
-        switch (waveformType)
-        {
-            case 0: // Sine
-                oscillators[i].initialise([](float x) { return std::sin(x); });
-                break;
-            case 1: // Square
-                oscillators[i].initialise([](float x) { return x > 0.0f ? 1.0f : -1.0f; });
-                break;
-            case 2: // Triangle
-                oscillators[i].initialise([](float x) { 
-                    float normalized = (x + juce::MathConstants<float>::pi) / (2.0f * juce::MathConstants<float>::pi);
-                    return 2.0f * std::abs(2.0f * (normalized - std::floor(normalized + 0.5f))) - 1.0f;
-                });
-                break;
-            case 3: // Saw
-                oscillators[i].initialise([](float x) { 
-                    return (x + juce::MathConstants<float>::pi) / juce::MathConstants<float>::pi - 1.0f;
-                });
-                break;
-        }
+        case 1: // Square
+            return phase01 > 0.5f ? 1.0f : -1.0f;
+        case 2: // Triangle
+            return 2.0f * std::abs(2.0f * (phase01 - std::floor(phase01 + 0.5f))) - 1.0f;
+        case 3: // Saw
+            return 2.0f * phase01 - 1.0f;
+        default: // Sine
+            return std::sin(phase01 * juce::MathConstants<float>::twoPi - juce::MathConstants<float>::pi);
     }
 }
 
 void PadVoice::prepare(double sampleRate, int samplesPerBlock)
 {
-    // Prepare the filter with the correct sample rate
-    juce::dsp::ProcessSpec spec;
-    spec.sampleRate = sampleRate;
-    spec.maximumBlockSize = static_cast<juce::uint32>(samplesPerBlock);
-    spec.numChannels = 1; // Mono processing
-    
-    filter.prepare(spec);
-    
-    // Prepare LFOs
-    filterLFO.prepare(spec);
-    pitchLFO.prepare(spec);
+    // Rendering runs a control block at a time, whatever the host block size
+    juce::ignoreUnused(samplesPerBlock);
     
-    // Set LFO rates
-    updateLFORates();
+    // Prepare the stereo filter with the correct sample rate - left and right are always live
+    filter.prepare(sampleRate, 2, kControlBlockSize);
+    filter.setLaneEnabled(0, true);
+    filter.setLaneEnabled(1, true);
+    ladder.setSampleRate(sampleRate);
+    formant.setSampleRate(sampleRate);
+    resonator.prepare(sampleRate);
+    CentsTable::prepare();
+    CutoffTable::prepare();
     
     // Configure smoothed values with 50ms smoothing time (buttery smooth)
     const float smoothingTimeMs = 50.0f; // 30-80ms range, using 50ms for buttery smooth
-    smoothedFilterCutoff.reset(sampleRate, smoothingTimeMs / 1000.0f);
-    smoothedFilterResonance.reset(sampleRate, smoothingTimeMs / 1000.0f);
-    smoothedDetuneAmount.reset(sampleRate, smoothingTimeMs / 1000.0f);
-    smoothedFilterEnvelopeAmount.reset(sampleRate, smoothingTimeMs / 1000.0f);
-    smoothedFilterLFODepth.reset(sampleRate, smoothingTimeMs / 1000.0f);
-    smoothedPitchLFODepth.reset(sampleRate, smoothingTimeMs / 1000.0f);
+    smoothing.reset(sampleRate, smoothingTimeMs / 1000.0f);
     
     // Configure envelope smoother for stable transitions (30ms smoothing)
-    envelopeSmoother.reset(sampleRate, 0.03f);
-    envelopeSmoother.setCurrentAndTargetValue(0.0f);
+    envelopeSmoothingCoefficient = 1.0f / juce::jmax(1.0f, std::floor(0.03f * static_cast<float>(sampleRate)));
+    lastEnvelopeLevel = 0.0f;
     
     // Reset all states
     filter.reset();
+    ladder.reset();
+    formant.reset();
     filterEnvelope.reset();
-    filterLFO.reset();
-    pitchLFO.reset();
+    filterEnvelopeLevel = 0.0f;
+    filterLFOPhase = 0.0f;
+    pitchLFOPhase = 0.0f;
+    silenceDetector.prepare(sampleRate);
 }
 
 void PadVoice::initializeUnisonOscillators()
 {
-    // Initialize oscillators with sine wave (will be updated by setWaveform)
-    for (int i = 0; i < kOsc; ++i)
-    {
-        oscillators[i].initialise([](float x) { return std::sin(x); });
-    }
-    
     // Set up panning positions for Lush Pad A: 40% spread
     pan[0] = -0.2f;  // -20%
     pan[1] = -0.1f;  // -10%
@@ -357,8 +519,11 @@ void PadVoice::initializeUnisonOscillators()
     for (int i = 0; i < kOsc; ++i)
     {
         phase[i] = 0.0; // All oscillators start in phase
+        oscPhase[i] = static_cast<float>(phase[i]);
     }
     
+    updateUnisonDetuning();
+    
     // Initialize precomputed pan gains for performance
     updatePanGains();
 }
@@ -367,39 +532,63 @@ void PadVoice::updatePanGains()
 {
     // Performance optimization: Precompute pan gains to avoid per-sample calculations
     for (int i = 0; i < kOsc; ++i)
-    {
-        // Simple left/right panning calculation
-        leftPanGains[i] = (pan[i] <= 0.0f) ? (1.0f + pan[i]) : (1.0f - pan[i]);
-        rightPanGains[i] = (pan[i] >= 0.0f) ? (1.0f - pan[i]) : (1.0f + pan[i]);
-    }
+        PanTable::gains(pan[i], leftPanGains[i], rightPanGains[i]);
     panGainsNeedUpdate = false;
 }
 
 void PadVoice::updateUnisonDetuning()
 {
-    // Always use the current note frequency for unison detuning
-    // The global frequency is only used for the main frequency display
-    float baseFreq = currentFrequency;
+    // Cache the static detune ratios - the note frequency and live pitch
+    // modulation are folded in per control block by updatePitchModulation()
+    for (int i = 0; i < kOsc; ++i)
+        detuneRatios[i] = CentsTable::centsToRatio(static_cast<float>(detune[i]));
+}
+
+void PadVoice::updatePitchModulation(int numSamples)
+{
+    // Always use the current note frequency - the global frequency is only
+    // used for the main frequency display
+    const float sampleRate = static_cast<float>(getSampleRate());
     
-    // Add minimal pitch LFO modulation for subtle vibrato (very minimal depth)
-    float pitchLFOValue = pitchLFO.processSample(0.0f);
-    float pitchModulation = pitchLFOValue * smoothedPitchLFODepth.getNextValue() * 0.02f; // Very minimal depth
-    baseFreq *= (1.0f + pitchModulation);
+    // Vibrato LFO sampled once per control block, depth in cents
+    const float lfoValue = std::sin(pitchLFOPhase * juce::MathConstants<float>::twoPi);
+    pitchLFOPhase += pitchLFORate * static_cast<float>(numSamples) / sampleRate;
+    pitchLFOPhase -= std::floor(pitchLFOPhase);
     
-    DBG("PadVoice::updateUnisonDetuning - baseFreq: " << baseFreq << ", globalFreq: " << globalFrequency << ", currentFreq: " << currentFrequency);
+    const float vibratoCents = lfoValue * smoothing.getValues(smoothedPitchLFODepth)[numSamples - 1];
+    const float glideCents = glide.advance(numSamples);
+    const float pitchRatio = CentsTable::centsToRatio(vibratoCents + pitchBendCents + glideCents);
     
+    const float baseIncrement = currentFrequency * pitchRatio / sampleRate;
     for (int i = 0; i < kOsc; ++i)
-    {
-        // Convert cents to frequency ratio
-        double detuneRatio = std::pow(2.0, detune[i] / 1200.0);
-        float detunedFreq = baseFreq * static_cast<float>(detuneRatio);
-        
-        DBG("Oscillator " << i << " detuned freq: " << detunedFreq << " (detune: " << detune[i] << " cents)");
-        oscillators[i].setFrequency(detunedFreq);
-    }
+        oscIncrement[i] = baseIncrement * detuneRatios[i];
+    
+    // The resonator follows the same pitch, glide and vibrato included
+    resonator.setPeriod(1.0f / baseIncrement);
 }
 
-float PadVoice::processUnisonSample()
+void PadVoice::updateFilterModulation(int numSamples)
+{
+    const float sampleRate = static_cast<float>(getSampleRate());
+    
+    // Filter LFO sampled once per control block
+    const float lfoValue = std::sin(filterLFOPhase * juce::MathConstants<float>::twoPi);
+    filterLFOPhase += filterLFORate * static_cast<float>(numSamples) / sampleRate;
+    filterLFOPhase -= std::floor(filterLFOPhase);
+    
+    // Add velocity mapping to cutoff for brightness expression (vel * 1500 Hz)
+    const float velocityCutoffModulation = currentVelocity * 1500.0f;
+    
+    // Filter envelope and LFO with minimal depth for stability
+    const float envelopeModulation = filterEnvelopeLevel * smoothing.getValues(smoothedFilterEnvelopeAmount)[0] * 0.1f;
+    const float lfoModulation = lfoValue * smoothing.getValues(smoothedFilterLFODepth)[0] * 0.05f;
+    
+    controlCutoff = juce::jlimit(100.0f, 8000.0f,
+        smoothing.getValues(smoothedFilterCutoff)[0] + velocityCutoffModulation + envelopeModulation + lfoModulation);
+    controlResonance = smoothing.getValues(smoothedFilterResonance)[0];
+}
+
+void PadVoice::processUnisonSample(float& left, float& right, float& modulator)
 {
     // Performance optimization: Update pan gains only when needed
     if (panGainsNeedUpdate)
@@ -415,7 +604,13 @@ float PadVoice::processUnisonSample()
     for (int i = 0; i < activeOscillators; ++i)
     {
         // Generate oscillator sample
-        float oscValue = oscillators[i].processSample(0.0f);
+        float oscValue = renderWaveform(oscPhase[i]);
+        oscPhase[i] += oscIncrement[i];
+        if (oscPhase[i] >= 1.0f) oscPhase[i] -= 1.0f;
+        
+        // The centre oscillator doubles as the filter FM source
+        if (i == 0)
+            modulator = oscValue;
         
         // Apply smooth crossfading based on active count
         float crossfadeGain = 1.0f;
@@ -446,14 +641,15 @@ float PadVoice::processUnisonSample()
         DBG("processUnisonSample - oscillatorCount: " << oscillatorCount << ", leftSample: " << leftSample << ", rightSample: " << rightSample);
     }
     
-    // Return mono mix (left + right) / 2
-    return (leftSample + rightSample) * 0.5f;
+    // Keep the stereo image - each channel is filtered in its own lane
+    left = leftSample;
+    right = rightSample;
 }
 
 // Filter envelope controls
 void PadVoice::setFilterEnvelopeAmount(float amount)
 {
-    smoothedFilterEnvelopeAmount.setTargetValue(juce::jlimit(0.0f, 3000.0f, amount));
+    smoothing.setTargetValue(smoothedFilterEnvelopeAmount, juce::jlimit(0.0f, 3000.0f, amount));
 }
 
 void PadVoice::setFilterEnvelopeAttack(float attack)
@@ -483,24 +679,22 @@ void PadVoice::setFilterEnvelopeRelease(float release)
 // LFO controls
 void PadVoice::setFilterLFODepth(float depth)
 {
-    smoothedFilterLFODepth.setTargetValue(juce::jlimit(0.0f, 800.0f, depth));
+    smoothing.setTargetValue(smoothedFilterLFODepth, juce::jlimit(0.0f, 800.0f, depth));
 }
 
 void PadVoice::setFilterLFORate(float rate)
 {
     filterLFORate = juce::jlimit(0.05f, 0.2f, rate);
-    updateLFORates();
 }
 
 void PadVoice::setPitchLFODepth(float depth)
 {
-    smoothedPitchLFODepth.setTargetValue(juce::jlimit(0.0f, 12.0f, depth));
+    smoothing.setTargetValue(smoothedPitchLFODepth, juce::jlimit(0.0f, 12.0f, depth));
 }
 
 void PadVoice::setPitchLFORate(float rate)
 {
     pitchLFORate = juce::jlimit(4.0f, 6.0f, rate);
-    updateLFORates();
 }
 
 // Helper methods
@@ -508,9 +702,3 @@ void PadVoice::updateFilterEnvelopeParameters()
 {
     filterEnvelope.setParameters(filterEnvelopeParams);
 }
-
-void PadVoice::updateLFORates()
-{
-    filterLFO.setFrequency(filterLFORate);
-    pitchLFO.setFrequency(pitchLFORate);
-}
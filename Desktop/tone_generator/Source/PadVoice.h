@@ -2,6 +2,17 @@
 
 #include <JuceHeader.h>
 #include "PadSound.h"
+#include "PitchTables.h"
+#include "Glide.h"
+#include "Tuning.h"
+#include "SilenceDetector.h"
+#include "SmoothingBank.h"
+#include "LadderFilter.h"
+#include "SVFBank.h"
+#include "PanTable.h"
+#include "FormantFilter.h"
+#include "Resonator.h"
+#include "Definitions.h"
 
 class PadVoice : public juce::SynthesiserVoice
 {
@@ -25,6 +36,24 @@ public:
     void setEnvelopeRelease(float release);
     void setFilterCutoff(float cutoff);
     void setFilterResonance(float resonance);
+    void setFilterModel(int model);            // FILTER_MODEL_CLASSIC or FILTER_MODEL_LADDER
+    void setFilterOversampling(bool shouldOversample);
+    int getFilterModel() const { return filterModel; }
+    
+    // Audio-rate filter FM (classic model): the first unison oscillator sweeps the cutoff
+    // by +-amount * SVFBank::kMaxModulationDepth of itself, per sample. 0 turns it off.
+    void setFilterFM(float amount);
+    float getFilterFMDepth() const { return filterFMDepth; }
+    
+    // Formant (vowel) stage after the unison sum
+    void setFormantEnabled(bool shouldBeEnabled);
+    void setFormantVowel(float vowelPosition);      // 0..4 = A E I O U, fractional values morph
+    
+    // Pitch-tracked comb/allpass resonator after the filter (0 amounts = bypass)
+    void setResonatorComb(float amount);
+    void setResonatorDecay(float seconds);
+    void setResonatorDamping(float damping);
+    void setResonatorAllpass(float depth);
     
     // Filter envelope controls
     void setFilterEnvelopeAmount(float amount);
@@ -39,6 +68,17 @@ public:
     void setPitchLFODepth(float depth);
     void setPitchLFORate(float rate);
     
+    // Portamento / legato
+    void setGlideMode(GlideRamp::Mode mode);
+    void setGlideTime(float seconds);
+    void setGlideRate(float semitonesPerSecond);
+    void setGlideOrigin(int midiNoteNumber);   // Note a freshly started voice glides from (-1 = none)
+    void beginLegatoTransition();              // Next stopNote/startNote pair retargets instead of retriggering
+    float getCurrentVelocity() const { return currentVelocity; }
+    
+    // Released voices end once their output stays below this level
+    void setSilenceThreshold(float thresholdDb);
+    
     // Global controls
     void setGlobalFrequency(double frequencyHz);
     void setWaveform(int waveformType);
@@ -48,18 +88,35 @@ public:
     
     // Performance monitoring
     bool isVoiceActive() const override { return isActive; }
+    float getCurrentLevel() const { return isActive ? lastEnvelopeLevel : 0.0f; } // For the synth's steal policy
+    
+    // Split rendering, used by PadSynthesizer to run every voice's filter in one
+    // SVFBank pass (left and right in adjacent lanes). Each call covers at most
+    // one control block. With filter FM on, the modulator is written to the two
+    // modulation lanes as well (they may be null when it is off).
+    static constexpr int kControlBlockSize = 32;
+    void renderSource(float* left, float* right, int stride, float* gains, int numSamples,
+                      float* leftModulation = nullptr, float* rightModulation = nullptr);
+    void renderFiltered(juce::AudioBuffer<float>& outputBuffer, int startSample,
+                        const float* left, const float* right, int stride, const float* gains, int numSamples);
+    float getControlCutoff() const { return controlCutoff; }
+    float getControlResonance() const { return controlResonance; }
     
 private:
     // Unison oscillators with detuning and panning
     static constexpr int kOsc = 6; // 4-8 oscillators per voice
-    std::array<juce::dsp::Oscillator<float>, kOsc> oscillators;
     std::array<float, kOsc> pan;        // -1..+1 panning
     std::array<double, kOsc> detune;    // in cents
     std::array<double, kOsc> phase;     // random initial phase
+    
+    // Phase accumulators (0..1) - increments are refreshed once per control block
+    std::array<float, kOsc> oscPhase {};
+    std::array<float, kOsc> oscIncrement {};
+    std::array<float, kOsc> detuneRatios {}; // Cached 2^(detune/1200) per oscillator
             int oscillatorCount = 3; // Ultra-stable preset: 3 oscillators
     float detuneAmount = 0.1f; // Detune amount in semitones (legacy)
     
-    // Performance optimization: Precomputed pan gains to avoid per-sample mallocs
+    // Performance optimization: Precomputed constant-power pan gains (PanTable)
     std::array<float, kOsc> leftPanGains;   // Precomputed left channel gains
     std::array<float, kOsc> rightPanGains;  // Precomputed right channel gains
     bool panGainsNeedUpdate = true;         // Flag to update pan gains when needed
@@ -67,29 +124,54 @@ private:
     // Envelope with smoothing
     juce::ADSR envelope;
     juce::ADSR::Parameters envelopeParams;
-    juce::SmoothedValue<float> envelopeSmoother;  // Smooth envelope transitions
-    float lastEnvelopeLevel = 0.0f;               // Previous envelope level for smoothing
+    float lastEnvelopeLevel = 0.0f;               // One-pole smoothed envelope level
+    float envelopeSmoothingCoefficient = 1.0f;    // 1 / smoothing steps (30ms)
     
-    // Filter
-    juce::dsp::StateVariableTPTFilter<float> filter;
+    // Stereo filter as one SIMD pair (only used when the voice renders itself -
+    // PadSynthesizer filters through its own bank)
+    SVFBank filter;
+    float controlCutoff = 1200.0f;     // Modulated cutoff for the current control block
+    float controlResonance = 0.6f;
+    
+    // Ladder alternative - filters in renderNextBlock, never through the SVFBank
+    LadderFilter ladder { 2 };
+    int filterModel = FILTER_MODEL_CLASSIC;
+    float filterFMDepth = 0.0f;
+    
+    FormantFilter formant { 2 };
+    bool formantEnabled = false;
+    
+    Resonator resonator { 2 };   // Delay lines allocated in prepare, tuned every control block
     
     // Filter envelope for movement
     juce::ADSR filterEnvelope;
     juce::ADSR::Parameters filterEnvelopeParams;
     float filterEnvelopeAmount = 2000.0f; // +1-3 kHz envelope amount
+    float filterEnvelopeLevel = 0.0f;     // Last filter envelope sample, read at control rate
     
-    // LFO for evolving timbre
-    juce::dsp::Oscillator<float> filterLFO;
+    // LFO for evolving timbre (control rate, like the pitch LFO)
+    float filterLFOPhase = 0.0f;
     float filterLFODepth = 400.0f; // 200-800 Hz depth
     float filterLFORate = 0.12f;   // Lush Pad A: 0.12 Hz rate
     
-    // Pitch LFO for vibrato
-    juce::dsp::Oscillator<float> pitchLFO;
+    // Pitch LFO for vibrato (control rate - evaluated once per control block)
+    float pitchLFOPhase = 0.0f;
     float pitchLFODepth = 8.0f;    // ±5-12 cents depth
     float pitchLFORate = 5.0f;     // 4-6 Hz rate
     
+    // Pitch wheel
+    float pitchBendCents = 0.0f;
+    float pitchBendRangeCents = 200.0f; // ±2 semitones
+    
+    // Portamento
+    GlideRamp glide;
+    int glideOriginNote = -1;
+    bool legatoTransitionPending = false;
+    
     // Voice state
     bool isActive = false;
+    bool noteReleased = false;
+    SilenceDetector silenceDetector;
     float currentVelocity = 0.0f;
     float currentFrequency = 0.0f;
     
@@ -97,22 +179,29 @@ private:
     double globalFrequency = 440.0;
     int currentWaveform = 0; // 0=Sine, 1=Square, 2=Triangle, 3=Saw
     
-    // Smoothed parameters to eliminate zipper noise
-    juce::SmoothedValue<float> smoothedFilterCutoff;
-    juce::SmoothedValue<float> smoothedFilterResonance;
-    juce::SmoothedValue<float> smoothedDetuneAmount;
-    juce::SmoothedValue<float> smoothedFilterEnvelopeAmount;
-    juce::SmoothedValue<float> smoothedFilterLFODepth;
-    juce::SmoothedValue<float> smoothedPitchLFODepth;
+    // Smoothed parameters to eliminate zipper noise, ramped a control block at a time
+    enum SmoothedParameter
+    {
+        smoothedFilterCutoff,
+        smoothedFilterResonance,
+        smoothedFilterEnvelopeAmount,
+        smoothedFilterLFODepth,
+        smoothedPitchLFODepth,
+        smoothedFormantVowel,
+        numSmoothedParameters
+    };
+    SmoothingBank<numSmoothedParameters, kControlBlockSize> smoothing;
     
     // Helper methods
     void updateOscillatorFrequencies();
     void updateEnvelopeParameters();
     void updateFilterParameters();
     void updateFilterEnvelopeParameters();
-    void updateLFORates();
     void initializeUnisonOscillators();
     void updateUnisonDetuning();
     void updatePanGains(); // Performance optimization: Precompute pan gains
-    float processUnisonSample();
+    void updatePitchModulation(int numSamples);
+    void updateFilterModulation(int numSamples);
+    float renderWaveform(float phase01) const;
+    void processUnisonSample(float& left, float& right, float& modulator);
 };
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include "LazyTable.h"
+
+// Precomputed pitch lookups so modulation never needs std::pow on the audio thread
+class CentsTable
+{
+public:
+    // Returns 2^(cents / 1200): whole octaves are applied exactly, the remainder
+    // is linearly interpolated from a 1-cent table (max relative error ~4e-8)
+    static float centsToRatio(float cents) noexcept
+    {
+        const auto& ratios = Ratios::get();
+
+        const float octaves = std::floor(cents * (1.0f / 1200.0f));
+        const float fineCents = cents - octaves * 1200.0f;
+
+        int index = static_cast<int>(fineCents);
+        if (index > kTableSize - 2)
+            index = kTableSize - 2;
+
+        const float fraction = fineCents - static_cast<float>(index);
+        const float ratio = ratios[static_cast<size_t>(index)]
+                          + fraction * (ratios[static_cast<size_t>(index + 1)] - ratios[static_cast<size_t>(index)]);
+
+        return std::ldexp(ratio, static_cast<int>(octaves));
+    }
+
+    // The inverse, 1200 * log2(ratio): whole octaves come from the float exponent and the
+    // remainder is found in the same table by binary search (0 for ratios <= 0)
+    static float ratioToCents(float ratio) noexcept
+    {
+        if (! (ratio > 0.0f))
+            return 0.0f;
+
+        const auto& ratios = Ratios::get();
+
+        int exponent = 0;
+        const float mantissa = 2.0f * std::frexp(ratio, &exponent); // 1 <= mantissa < 2
+
+        const auto above = std::upper_bound(ratios.begin(), ratios.end(), mantissa);
+        const int index = std::min(kTableSize - 2, std::max(0, static_cast<int>(above - ratios.begin()) - 1));
+
+        const float lower = ratios[static_cast<size_t>(index)];
+        const float fraction = (mantissa - lower) / (ratios[static_cast<size_t>(index + 1)] - lower);
+
+        return static_cast<float>(exponent - 1) * 1200.0f + static_cast<float>(index) + fraction;
+    }
+
+    static void prepare() { Ratios::prepare(); }
+
+private:
+    static constexpr int kTableSize = 1201; // 0..1200 cents inclusive
+
+    static std::array<float, kTableSize> buildRatios()
+    {
+        std::array<float, kTableSize> values {};
+        for (int i = 0; i < kTableSize; ++i)
+            values[static_cast<size_t>(i)] = static_cast<float>(std::pow(2.0, i / 1200.0));
+        return values;
+    }
+
+    using Ratios = LazyTable<std::array<float, kTableSize>, buildRatios>;
+};
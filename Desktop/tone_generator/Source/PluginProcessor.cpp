@@ -126,12 +126,22 @@ juce::AudioProcessor::BusesProperties JuceDemoPluginAudioProcessor::getBusesProp
 
 
 //==============================================================================
-void JuceDemoPluginAudioProcessor::prepareToPlay (double newSampleRate, int /*samplesPerBlock*/)
+void JuceDemoPluginAudioProcessor::prepareToPlay (double newSampleRate, int samplesPerBlock)
 {
     // Use this method as the place to do any pre-playback
     // initialisation that you need..
     synth.setCurrentPlaybackSampleRate (newSampleRate);
     keyboardState.reset();
+
+    // The mastering switch (masterEQLinearPhase) is only read here, so a change to it
+    // takes effect on the next prepare. Offline rendering can still change the engine, and
+    // the latency reported with it, at any time through setNonRealtime() below.
+    masterEQ.setMode (ParameterHolder::inst().masterEQLinearPhase.load() ? MasterEQ::Mode::linearPhase
+                                                                         : MasterEQ::Mode::live);
+    masterEQ.setNonRealtime (isNonRealtime());
+    masterEQ.prepare ({ newSampleRate, (juce::uint32) juce::jmax (1, samplesPerBlock), 2 });
+    setLatencySamples (masterEQ.getLatencySamples());
+
     reset();
 }
 
@@ -144,6 +154,16 @@ void JuceDemoPluginAudioProcessor::releaseResources()
 
 void JuceDemoPluginAudioProcessor::reset()
 {
+    masterEQ.reset();
+}
+
+void JuceDemoPluginAudioProcessor::setNonRealtime (bool isNonRealtime) noexcept
+{
+    juce::AudioProcessor::setNonRealtime (isNonRealtime);
+
+    // Bounces switch the master EQ to linear phase - report the latency that comes with it
+    masterEQ.setNonRealtime (isNonRealtime);
+    setLatencySamples (masterEQ.getLatencySamples());
 }
 
 void JuceDemoPluginAudioProcessor::process (juce::AudioBuffer<float>& buffer,
@@ -214,6 +234,14 @@ void JuceDemoPluginAudioProcessor::process (juce::AudioBuffer<float>& buffer,
 
 		}
 	}
+
+	for (int band = 0; band < MasterEQ::kNumBands; ++band)
+	{
+		const auto& params = ParameterHolder::inst();
+		masterEQ.setBand(band, params.masterEQFrequency[static_cast<size_t>(band)].load(),
+		                 params.masterEQGain[static_cast<size_t>(band)].load(), params.masterEQQ[static_cast<size_t>(band)].load());
+	}
+	masterEQ.process(buffer, 0, numSamples);
 }
 
 //==============================================================================
@@ -240,6 +268,16 @@ void JuceDemoPluginAudioProcessor::getStateInformation (juce::MemoryBlock& destD
         if (juce::AudioProcessorParameterWithID* p = dynamic_cast<juce::AudioProcessorParameterWithID*> (getParameters().getUnchecked(i)))
             xml.setAttribute (p->paramID, p->getValue());
 
+    // ..and the master EQ bands, which aren't host parameters
+    auto& params = ParameterHolder::inst();
+    for (int band = 0; band < MasterEQ::kNumBands; ++band)
+    {
+        const auto index = static_cast<size_t> (band);
+        xml.setAttribute ("masterEQGain" + juce::String (band), params.masterEQGain[index].load());
+        xml.setAttribute ("masterEQFrequency" + juce::String (band), params.masterEQFrequency[index].load());
+        xml.setAttribute ("masterEQQ" + juce::String (band), params.masterEQQ[index].load());
+    }
+
     // then use this helper function to stuff it into the binary blob and return it..
     copyXmlToBinary (xml, destData);
 }
@@ -265,6 +303,15 @@ void JuceDemoPluginAudioProcessor::setStateInformation (const void* data, int si
             for (int i = 0; i < getParameters().size(); ++i)
                 if (juce::AudioProcessorParameterWithID* p = dynamic_cast<juce::AudioProcessorParameterWithID*> (getParameters().getUnchecked(i)))
                     p->setValue ((float) xmlState->getDoubleAttribute (p->paramID, p->getValue()));
+
+            auto& params = ParameterHolder::inst();
+            for (int band = 0; band < MasterEQ::kNumBands; ++band)
+            {
+                const auto index = static_cast<size_t> (band);
+                params.masterEQGain[index].store ((float) xmlState->getDoubleAttribute ("masterEQGain" + juce::String (band), params.masterEQGain[index].load()));
+                params.masterEQFrequency[index].store ((float) xmlState->getDoubleAttribute ("masterEQFrequency" + juce::String (band), params.masterEQFrequency[index].load()));
+                params.masterEQQ[index].store ((float) xmlState->getDoubleAttribute ("masterEQQ" + juce::String (band), params.masterEQQ[index].load()));
+            }
         }
     }
 }
@@ -298,4 +345,11 @@ ParameterHolder::ParameterHolder()
 	parameters[LFO_AMP_PARAM].store(0.0);
 	parameters[FILTER_START_PARAM].store(5000.0);
 	parameters[FILTER_END_PARAM].store(1.0);
+	parameters[GLIDE_TIME_PARAM].store(0.0f); // seconds, 0 = no portamento
+
+	for (size_t band = 0; band < MasterEQ::kNumBands; ++band)
+	{
+		masterEQFrequency[band].store(MasterEQ::kDefaultBands[band].frequency);
+		masterEQQ[band].store(MasterEQ::kDefaultBands[band].q);
+	}
 }
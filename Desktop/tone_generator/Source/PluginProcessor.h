@@ -10,6 +10,8 @@
 
 #include "Definitions.h"
 #include "WrattDelay.h"
+#include "MasterEQ.h"
+#include "VoiceAllocator.h"
 
 #ifdef __APPLE__
 #include "DSPFilters/Dsp.h"
@@ -41,6 +43,7 @@ public:
     void prepareToPlay (double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
     void reset() override;
+    void setNonRealtime (bool isNonRealtime) noexcept override;
 
     //==============================================================================
     void processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override
@@ -94,6 +97,7 @@ private:
     void process (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages);
 
 	juce::Synthesiser synth;
+	MasterEQ masterEQ;
 	std::vector<stk::FreeVerb> reverb;
 	std::vector<stk::Chorus> chorus;
 	std::vector<wratt_dsp::Delay> delay;
@@ -115,6 +119,36 @@ public:
 	std::array<std::atomic<float>, NUM_ALL_PARAMS> parameters;
 	int currentOsc = OSC_SAW;
 
+	// Filter model for every voice, read once per control block on the audio thread
+	std::atomic<int> filterModel { FILTER_MODEL_CLASSIC };
+	std::atomic<bool> filterOversampling { false };
+	std::atomic<float> ladderResonance { 0.6f };
+	std::atomic<float> filterFMAmount { 0.0f }; // 0..1 audio-rate cutoff FM from a voice oscillator (classic model)
+
+	// Formant (vowel) stage after the oscillator sum - vowel 0..4 = A E I O U
+	std::atomic<bool> formantEnabled { false };
+	std::atomic<float> formantVowel { 0.0f };
+
+	// Master EQ - per band (low shelf, low mid, high mid, high shelf) gain in dB, frequency
+	// in Hz and Q, and the linear-phase mastering engine (offline renders always use it)
+	std::array<std::atomic<float>, MasterEQ::kNumBands> masterEQGain {};
+	std::array<std::atomic<float>, MasterEQ::kNumBands> masterEQFrequency {};
+	std::array<std::atomic<float>, MasterEQ::kNumBands> masterEQQ {};
+	std::atomic<bool> masterEQLinearPhase { false };
+
+	// Legato: a new note takes over the voice of the most recent note still held and
+	// glides there over parameters[GLIDE_TIME_PARAM] instead of starting a voice of its own
+	std::atomic<bool> legato { false };
+
+	// Which sounding voice a new note takes over once every voice is busy
+	std::atomic<VoiceAllocator::StealPolicy> voiceStealPolicy { VoiceAllocator::StealPolicy::releasedFirst };
+
+	// Spread the voices over a pool of real-time worker threads (falls back to serial with few voices)
+	std::atomic<bool> parallelVoiceRendering { false };
+
+	// Quality tier picked from the measured callback load (see QualityController)
+	std::atomic<int> qualityTier { 0 };
+
 	static ParameterHolder & inst() {
 		static ParameterHolder params;
 		return params;
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+
+// Adaptive quality from the measured audio callback load. getLoadMeasurer() times every
+// callback (wrap the callback in a ScopedTimer) and update() walks a ladder of quality
+// tiers with hysteresis:
+//  - one tier down once the load has stayed above kDegradeLoad for kDegradeHoldSeconds,
+//    or straight away after an overrun
+//  - one tier up once it has stayed below kRestoreLoad for kRestoreHoldSeconds
+// Each change restarts both hold timers, and overruns are ignored for kDegradeHoldSeconds
+// after it, so the smoothed load gets to settle at the new tier before the next decision
+// and a burst of overruns costs one tier, not the whole ladder. The tier only says what to cut - the voices and the
+// effects chain do it (see Tier), each in a way that doesn't click.
+class QualityController
+{
+public:
+    struct Tier
+    {
+        int unisonOscillators;   // of the OscilVoice's six - dropped ones fade out, then aren't computed
+        bool allowOversampling;  // ladder filter oversampling, latched per note
+        int filterUpdateChunks;  // filter coefficients refreshed every n 32-sample chunks
+        bool effectsEnabled;     // reverb/chorus send - faded out, then skipped
+        int voiceLimit;          // sounding voices before new notes steal (0 = every voice)
+    };
+
+    static constexpr int kNumTiers = 4;
+    static constexpr std::array<Tier, kNumTiers> tiers {{
+        { 6, true,  1, true,  0 },  // full
+        { 4, true,  2, true,  10 }, // reduced
+        { 3, false, 4, true,  8 },  // low
+        { 3, false, 8, false, 6 }   // minimal
+    }};
+
+    static constexpr double kDegradeLoad = 0.8;
+    static constexpr double kRestoreLoad = 0.5;
+    static constexpr double kDegradeHoldSeconds = 0.2;
+    static constexpr double kRestoreHoldSeconds = 3.0;
+
+    static const Tier& getTier(int tier) noexcept { return tiers[static_cast<size_t>(juce::jlimit(0, kNumTiers - 1, tier))]; }
+
+    void prepare(double sampleRate, int samplesPerBlock)
+    {
+        loadMeasurer.reset(sampleRate, samplesPerBlock);
+        degradeHoldSamples = juce::roundToInt(sampleRate * kDegradeHoldSeconds);
+        restoreHoldSamples = juce::roundToInt(sampleRate * kRestoreHoldSeconds);
+        lastXRunCount = 0;
+        samplesOverLoad = samplesUnderLoad = samplesSinceChange = 0;
+    }
+
+    juce::AudioProcessLoadMeasurer& getLoadMeasurer() noexcept { return loadMeasurer; }
+
+    // Audio thread, once per callback. Returns the tier to run this callback at
+    // (0 = full quality, kNumTiers - 1 = minimal).
+    int update(int numSamples) noexcept
+    {
+        const double load = loadMeasurer.getLoadAsProportion();
+        const int xRuns = loadMeasurer.getXRunCount();
+
+        // An overrun in the dwell after a change is most likely the same one, or the
+        // change itself still settling - don't let it take another tier
+        const bool overran = xRuns != lastXRunCount && samplesSinceChange >= degradeHoldSamples;
+        lastXRunCount = xRuns;
+        samplesSinceChange = juce::jmin(samplesSinceChange + numSamples, degradeHoldSamples);
+
+        samplesOverLoad = load > kDegradeLoad ? samplesOverLoad + numSamples : 0;
+        samplesUnderLoad = load < kRestoreLoad ? samplesUnderLoad + numSamples : 0;
+
+        if ((overran || samplesOverLoad >= degradeHoldSamples) && tier < kNumTiers - 1)
+            changeTier(tier + 1);
+        else if (samplesUnderLoad >= restoreHoldSamples && tier > 0)
+            changeTier(tier - 1);
+
+        return tier;
+    }
+
+    int getCurrentTier() const noexcept { return tier; }
+    double getLoad() const { return loadMeasurer.getLoadAsProportion(); }
+
+private:
+    void changeTier(int newTier) noexcept
+    {
+        tier = newTier;
+        samplesOverLoad = samplesUnderLoad = samplesSinceChange = 0;
+    }
+
+    juce::AudioProcessLoadMeasurer loadMeasurer;
+    int tier = 0;
+    int lastXRunCount = 0;
+    int samplesOverLoad = 0, samplesUnderLoad = 0;
+    int samplesSinceChange = 0; // up to degradeHoldSamples, the overrun dwell
+    int degradeHoldSamples = 9600, restoreHoldSamples = 144000;
+};
@@ -0,0 +1,225 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <cmath>
+#include <vector>
+
+// Pitch-tracked resonator insert for one voice:
+//  - a feedback comb tuned to the note period with a one-pole damping filter in the
+//    loop (Karplus-Strong style resonance on every harmonic)
+//  - a chain of Schroeder allpasses, also one period long, mixed back with the dry
+//    signal - the phase wraps once per harmonic spacing, so each stage cuts one
+//    phaser-like notch between every pair of harmonics
+// Every delay line is carved out of one arena allocated in prepare(), sized for the
+// lowest note at that rate, and taps are read with linear interpolation so the
+// tuning follows glides and vibrato. Processing runs a stage at a time over the block.
+class Resonator
+{
+public:
+    static constexpr int kMaxChannels = 2;
+    static constexpr int kNumAllpasses = 4;
+    static constexpr float kMinFrequency = 27.5f; // A0 - lower notes resonate an octave up
+
+    explicit Resonator(int numChannelsToUse)
+        : numChannels(juce::jlimit(1, kMaxChannels, numChannelsToUse)) {}
+
+    // Allocates the arena - call from prepare, never from the audio thread
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        maxPeriod = static_cast<float>(sampleRate / kMinFrequency);
+
+        // Power-of-two lines so read and write positions wrap with a mask
+        lineSize = juce::nextPowerOfTwo(static_cast<int>(std::ceil(maxPeriod)) + 2);
+        lineMask = lineSize - 1;
+        arena.assign(static_cast<size_t>(numChannels * kLinesPerChannel * lineSize), 0.0f);
+
+        period = 0.0f;
+        setPeriod(static_cast<float>(sampleRate / 440.0));
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        std::fill(arena.begin(), arena.end(), 0.0f);
+        dampingState.fill(0.0f);
+        writePosition = 0;
+        linesNeedClearing = false;
+    }
+
+    // Control rate: the current note period in samples (sampleRate / frequency)
+    void setPeriod(float newPeriod) noexcept
+    {
+        float limited = juce::jmax(2.0f, newPeriod);
+        while (limited > maxPeriod)
+            limited *= 0.5f;
+
+        if (limited == period)
+            return;
+
+        period = limited;
+        updateComb();
+    }
+
+    // 0 = bypass, 1 = comb output only
+    void setCombAmount(float amount) noexcept
+    {
+        const float limited = juce::jlimit(0.0f, 1.0f, amount);
+        if (combAmount == 0.0f && limited > 0.0f)
+            linesNeedClearing = true; // don't resume from whatever rang there last time
+        combAmount = limited;
+    }
+
+    // Time for the comb's resonance to fall by 60 dB
+    void setDecayTime(float seconds) noexcept
+    {
+        decayTime = juce::jlimit(0.01f, 20.0f, seconds);
+        updateComb();
+    }
+
+    // 0 = bright (every harmonic rings as long), towards 1 = upper harmonics die away quickly
+    void setDamping(float amount) noexcept
+    {
+        damping = juce::jlimit(0.0f, 0.9f, amount);
+        updateComb();
+    }
+
+    // 0 = bypass, 1 = deepest notches (dry and allpass chain in equal parts)
+    void setAllpassDepth(float depth) noexcept
+    {
+        const float limited = juce::jlimit(0.0f, 1.0f, depth);
+        if (allpassDepth == 0.0f && limited > 0.0f)
+            linesNeedClearing = true;
+        allpassDepth = limited;
+    }
+
+    bool isActive() const noexcept { return combAmount > 0.0f || allpassDepth > 0.0f; }
+
+    // Processes numChannels channels in place
+    void process(float* const* channels, int numSamples) noexcept
+    {
+        if (! isActive() || arena.empty())
+            return;
+
+        if (linesNeedClearing)
+            reset();
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            if (combAmount > 0.0f)
+                processComb(channels[ch], ch, numSamples);
+
+            if (allpassDepth > 0.0f)
+                processAllpasses(channels[ch], ch, numSamples);
+        }
+
+        writePosition = (writePosition + numSamples) & lineMask;
+    }
+
+private:
+    static constexpr int kLinesPerChannel = 1 + kNumAllpasses;
+    static constexpr float kAllpassGain = 0.6f;
+    static constexpr int kChunkSize = 32;
+
+    float* line(int channel, int index) noexcept
+    {
+        return arena.data() + (channel * kLinesPerChannel + index) * lineSize;
+    }
+
+    // Linear-interpolated tap delay samples behind position (delay >= 1)
+    float read(const float* buffer, int position, float delay) const noexcept
+    {
+        const int whole = static_cast<int>(delay);
+        const float fraction = delay - static_cast<float>(whole);
+        const float a = buffer[(position - whole) & lineMask];
+        const float b = buffer[(position - whole - 1) & lineMask];
+        return a + fraction * (b - a);
+    }
+
+    void updateComb() noexcept
+    {
+        if (period <= 0.0f)
+            return;
+
+        // The damping filter delays the loop by d / (1 - d) samples at low frequencies -
+        // take it off the line so the comb stays in tune
+        combDelay = juce::jmax(1.0f, period - damping / (1.0f - damping));
+        combFeedback = std::pow(0.001f, period / (decayTime * static_cast<float>(sampleRate)));
+
+        // Scaling the input by 1 - g puts the resonant peaks at unity gain
+        combInputGain = 1.0f - combFeedback;
+    }
+
+    void processComb(float* data, int channel, int numSamples) noexcept
+    {
+        float* buffer = line(channel, 0);
+        float lowpass = dampingState[static_cast<size_t>(channel)];
+        int position = writePosition;
+
+        for (int i = 0; i < numSamples; ++i, position = (position + 1) & lineMask)
+        {
+            const float delayed = read(buffer, position, combDelay);
+            lowpass = delayed + damping * (lowpass - delayed);
+
+            const float input = data[i];
+            buffer[position] = input * combInputGain + lowpass * combFeedback;
+            data[i] = input + combAmount * (lowpass - input);
+        }
+
+        dampingState[static_cast<size_t>(channel)] = lowpass;
+    }
+
+    void processAllpasses(float* data, int channel, int numSamples) noexcept
+    {
+        const float wetGain = 0.5f * allpassDepth;
+        const float dryGain = 1.0f - wetGain;
+
+        // Each stage runs over the chunk in place; the dry signal is kept aside for the mix
+        float dry[kChunkSize];
+        for (int start = 0; start < numSamples; start += kChunkSize)
+        {
+            const int count = juce::jmin(kChunkSize, numSamples - start);
+            float* chunk = data + start;
+            juce::FloatVectorOperations::copy(dry, chunk, count);
+
+            for (int stage = 0; stage < kNumAllpasses; ++stage)
+            {
+                float* buffer = line(channel, 1 + stage);
+                int position = (writePosition + start) & lineMask;
+
+                for (int i = 0; i < count; ++i, position = (position + 1) & lineMask)
+                {
+                    const float delayed = read(buffer, position, period);
+                    const float w = chunk[i] + kAllpassGain * delayed;
+                    buffer[position] = w;
+                    chunk[i] = delayed - kAllpassGain * w;
+                }
+            }
+
+            for (int i = 0; i < count; ++i)
+                chunk[i] = dryGain * dry[i] + wetGain * chunk[i];
+        }
+    }
+
+    const int numChannels;
+    double sampleRate = 44100.0;
+    float maxPeriod = 1600.0f;
+
+    std::vector<float> arena; // numChannels * kLinesPerChannel lines of lineSize samples
+    int lineSize = 0;
+    int lineMask = 0;
+    int writePosition = 0;
+    bool linesNeedClearing = false;
+
+    float period = 0.0f;
+    float combAmount = 0.0f;
+    float decayTime = 1.0f;
+    float damping = 0.3f;
+    float allpassDepth = 0.0f;
+
+    float combDelay = 1.0f;
+    float combFeedback = 0.0f;
+    float combInputGain = 1.0f;
+    std::array<float, kMaxChannels> dampingState {};
+};
@@ -0,0 +1,274 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <vector>
+#include "FilterTables.h"
+
+// TPT state-variable filters for a whole bank of voices, one voice per SIMD lane.
+// Coefficients and state are kept structure-of-arrays (one register per group of
+// lanes), so a single pass over a shared scratch block filters every voice at once.
+//
+// Scratch is interleaved by sample: lane l of sample n lives at
+// getLaneData(l)[n * getLaneStride()]. Voices write their unfiltered signal there,
+// process() filters in place, and the voices read their lane back.
+// Disabled lanes are masked to silence, groups with no enabled lanes are skipped,
+// and a lane starts again from a cleared state when it is re-enabled.
+//
+// Audio-rate cutoff modulation (filter FM): a lane with a non-zero modulation depth
+// reads a per-sample modulator from getModulationData(), laid out like the scratch,
+// and its cutoff becomes cutoff * (1 + depth * modulator). Those groups recompute g
+// every sample with CutoffTable::tanPolynomial across all lanes at once instead of
+// the control-rate table lookup.
+class SVFBank
+{
+public:
+    using Vec = juce::dsp::SIMDRegister<float>;
+    static constexpr int kLanesPerGroup = static_cast<int>(Vec::SIMDNumElements);
+
+    enum class Type { lowpass, bandpass, highpass };
+
+    // Deepest linear FM a lane accepts - beyond 1 the cutoff spends part of each cycle clamped low
+    static constexpr float kMaxModulationDepth = 4.0f;
+
+    void prepare(double newSampleRate, int numLanes, int maxBlockSize)
+    {
+        inverseSampleRate = static_cast<float>(1.0 / newSampleRate);
+        CutoffTable::prepare();
+        numGroups = (juce::jmax(1, numLanes) + kLanesPerGroup - 1) / kLanesPerGroup;
+        blockSize = juce::jmax(1, maxBlockSize);
+
+        const auto groups = static_cast<size_t>(numGroups);
+        const auto zero = Vec::expand(0.0f);
+        g.assign(groups, zero);
+        gPlusR2.assign(groups, zero);
+        h.assign(groups, zero);
+        laneMask.assign(groups, zero);
+        s1.assign(groups, zero);
+        s2.assign(groups, zero);
+        baseFrequency.assign(groups, zero);
+        r2.assign(groups, zero);
+        modulationDepth.assign(groups, zero);
+        enabledCount.assign(groups, 0);
+        modulatedCount.assign(groups, 0);
+        scratch.assign(groups * static_cast<size_t>(blockSize), zero);
+        modulation.assign(groups * static_cast<size_t>(blockSize), zero);
+
+        const auto lanes = static_cast<size_t>(getNumLanes());
+        laneCutoff.assign(lanes, -1.0f);
+        laneResonance.assign(lanes, -1.0f);
+
+        for (int lane = 0; lane < getNumLanes(); ++lane)
+            setLaneParameters(lane, 1000.0f, 0.707f);
+    }
+
+    // Allocation-free rate change for an already prepared bank; every lane recomputes on its next update
+    void setSampleRate(double newSampleRate) noexcept
+    {
+        const float newInverse = static_cast<float>(1.0 / newSampleRate);
+        if (newInverse == inverseSampleRate)
+            return;
+
+        inverseSampleRate = newInverse;
+        std::fill(laneCutoff.begin(), laneCutoff.end(), -1.0f);
+    }
+
+    void setType(Type newType) noexcept { type = newType; }
+
+    int getNumLanes() const noexcept     { return numGroups * kLanesPerGroup; }
+    int getLaneStride() const noexcept   { return numGroups * kLanesPerGroup; }
+    int getMaxBlockSize() const noexcept { return blockSize; }
+
+    float* getLaneData(int lane) noexcept
+    {
+        jassert(lane >= 0 && lane < getNumLanes());
+        return reinterpret_cast<float*>(scratch.data()) + lane;
+    }
+
+    // Per-sample modulator for a lane, same stride as getLaneData(); only read for
+    // lanes with a non-zero modulation depth
+    float* getModulationData(int lane) noexcept
+    {
+        jassert(lane >= 0 && lane < getNumLanes());
+        return reinterpret_cast<float*>(modulation.data()) + lane;
+    }
+
+    // Control rate: coefficients only change when a lane's cutoff or resonance actually moves
+    void setLaneParameters(int lane, float cutoffHz, float resonance) noexcept
+    {
+        const auto l = static_cast<size_t>(lane);
+        if (cutoffHz == laneCutoff[l] && resonance == laneResonance[l])
+            return;
+
+        laneCutoff[l] = cutoffHz;
+        laneResonance[l] = resonance;
+
+        const float gValue = CutoffTable::tanPrewarp(cutoffHz * inverseSampleRate);
+        const float r2Value = 1.0f / juce::jmax(0.01f, resonance);
+
+        const auto group = l / static_cast<size_t>(kLanesPerGroup);
+        const auto index = l % static_cast<size_t>(kLanesPerGroup);
+        g[group].set(index, gValue);
+        gPlusR2[group].set(index, gValue + r2Value);
+        h[group].set(index, 1.0f / (1.0f + r2Value * gValue + gValue * gValue));
+        baseFrequency[group].set(index, cutoffHz * inverseSampleRate);
+        r2[group].set(index, r2Value);
+    }
+
+    // Linear FM index: 0 = unmodulated, 1 swings the cutoff between 0 and twice its value
+    void setLaneModulationDepth(int lane, float depth) noexcept
+    {
+        const auto group = static_cast<size_t>(lane / kLanesPerGroup);
+        const auto index = static_cast<size_t>(lane % kLanesPerGroup);
+        const bool wasModulated = modulationDepth[group].get(index) != 0.0f;
+        const float limited = juce::jlimit(0.0f, kMaxModulationDepth, depth);
+
+        modulationDepth[group].set(index, limited);
+        modulatedCount[group] += (limited != 0.0f ? 1 : 0) - (wasModulated ? 1 : 0);
+    }
+
+    void setLaneEnabled(int lane, bool shouldBeEnabled) noexcept
+    {
+        const auto group = static_cast<size_t>(lane / kLanesPerGroup);
+        const auto index = static_cast<size_t>(lane % kLanesPerGroup);
+        const bool wasEnabled = laneMask[group].get(index) != 0.0f;
+
+        if (wasEnabled == shouldBeEnabled)
+            return;
+
+        laneMask[group].set(index, shouldBeEnabled ? 1.0f : 0.0f);
+        s1[group].set(index, 0.0f);
+        s2[group].set(index, 0.0f);
+        enabledCount[group] += shouldBeEnabled ? 1 : -1;
+    }
+
+    bool isLaneEnabled(int lane) const noexcept
+    {
+        return laneMask[static_cast<size_t>(lane / kLanesPerGroup)].get(static_cast<size_t>(lane % kLanesPerGroup)) != 0.0f;
+    }
+
+    void reset() noexcept
+    {
+        const auto zero = Vec::expand(0.0f);
+        std::fill(s1.begin(), s1.end(), zero);
+        std::fill(s2.begin(), s2.end(), zero);
+    }
+
+    // Filters the first numSamples (<= maxBlockSize) frames of the scratch block in place
+    void process(int numSamples) noexcept
+    {
+        jassert(numSamples <= blockSize);
+
+        switch (type)
+        {
+            case Type::lowpass:  processGroups<Type::lowpass>(numSamples);  break;
+            case Type::bandpass: processGroups<Type::bandpass>(numSamples); break;
+            case Type::highpass: processGroups<Type::highpass>(numSamples); break;
+        }
+    }
+
+private:
+    template <Type FilterType>
+    void processGroups(int numSamples) noexcept
+    {
+        for (int group = 0; group < numGroups; ++group)
+        {
+            const auto grp = static_cast<size_t>(group);
+            if (enabledCount[grp] == 0)
+                continue;
+
+            if (modulatedCount[grp] > 0)
+            {
+                processModulatedGroup<FilterType>(grp, numSamples);
+                continue;
+            }
+
+            const Vec gv = g[grp], gr = gPlusR2[grp], hv = h[grp], mask = laneMask[grp];
+            Vec z1 = s1[grp], z2 = s2[grp];
+            Vec* frame = scratch.data() + grp;
+
+            for (int n = 0; n < numSamples; ++n, frame += numGroups)
+            {
+                const Vec x = *frame * mask;
+                const Vec yHP = hv * (x - z1 * gr - z2);
+                const Vec yBP = yHP * gv + z1;
+                z1 = yHP * gv + yBP;
+                const Vec yLP = yBP * gv + z2;
+                z2 = yBP * gv + yLP;
+
+                if constexpr (FilterType == Type::lowpass)       *frame = yLP;
+                else if constexpr (FilterType == Type::bandpass) *frame = yBP;
+                else                                             *frame = yHP;
+            }
+
+            s1[grp] = z1;
+            s2[grp] = z2;
+        }
+    }
+
+    // Same filter with g worked out per sample from the modulated cutoff
+    template <Type FilterType>
+    void processModulatedGroup(size_t grp, int numSamples) noexcept
+    {
+        const Vec w0 = baseFrequency[grp], depth = modulationDepth[grp] * w0, mask = laneMask[grp];
+        const Vec minFrequency = Vec::expand(CutoffTable::kMinNormalisedFrequency);
+        const Vec maxFrequency = Vec::expand(CutoffTable::kMaxNormalisedFrequency);
+        Vec z1 = s1[grp], z2 = s2[grp];
+        Vec* frame = scratch.data() + grp;
+        const Vec* modulator = modulation.data() + grp;
+
+        alignas(Vec::SIMDRegisterSize) float r2Lanes[kLanesPerGroup];
+        alignas(Vec::SIMDRegisterSize) float tLanes[kLanesPerGroup];
+        alignas(Vec::SIMDRegisterSize) float gLanes[kLanesPerGroup];
+        alignas(Vec::SIMDRegisterSize) float grLanes[kLanesPerGroup];
+        alignas(Vec::SIMDRegisterSize) float hLanes[kLanesPerGroup];
+        r2[grp].copyToRawArray(r2Lanes);
+
+        for (int n = 0; n < numSamples; ++n, frame += numGroups, modulator += numGroups)
+        {
+            const Vec w = Vec::min(Vec::max(w0 + depth * *modulator, minFrequency), maxFrequency);
+            const Vec t = CutoffTable::tanPolynomial(w * juce::MathConstants<float>::halfPi);
+            t.copyToRawArray(tLanes);
+
+            // SIMDRegister has no divide - a fixed-length loop the compiler vectorises
+            for (int lane = 0; lane < kLanesPerGroup; ++lane)
+            {
+                const float gValue = 2.0f * tLanes[lane] / (1.0f - tLanes[lane] * tLanes[lane]);
+                gLanes[lane] = gValue;
+                grLanes[lane] = gValue + r2Lanes[lane];
+                hLanes[lane] = 1.0f / (1.0f + r2Lanes[lane] * gValue + gValue * gValue);
+            }
+
+            const Vec gv = Vec::fromRawArray(gLanes), gr = Vec::fromRawArray(grLanes), hv = Vec::fromRawArray(hLanes);
+
+            const Vec x = *frame * mask;
+            const Vec yHP = hv * (x - z1 * gr - z2);
+            const Vec yBP = yHP * gv + z1;
+            z1 = yHP * gv + yBP;
+            const Vec yLP = yBP * gv + z2;
+            z2 = yBP * gv + yLP;
+
+            if constexpr (FilterType == Type::lowpass)       *frame = yLP;
+            else if constexpr (FilterType == Type::bandpass) *frame = yBP;
+            else                                             *frame = yHP;
+        }
+
+        s1[grp] = z1;
+        s2[grp] = z2;
+    }
+
+    float inverseSampleRate = 1.0f / 44100.0f;
+    int numGroups = 0;
+    int blockSize = 0;
+    Type type = Type::lowpass;
+
+    // One register per group of kLanesPerGroup lanes
+    std::vector<Vec> g, gPlusR2, h, laneMask;
+    std::vector<Vec> baseFrequency, r2, modulationDepth; // per-sample coefficient inputs for modulated groups
+    std::vector<Vec> s1, s2;
+    std::vector<int> enabledCount, modulatedCount;
+    std::vector<Vec> scratch;    // blockSize frames of numGroups registers
+    std::vector<Vec> modulation; // ... and the matching modulator frames
+
+    std::vector<float> laneCutoff, laneResonance;
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Block-level peak tracking for released voices. Envelope tails and filter
+// ringing can keep a voice "active" long after it stops being audible; once the
+// output has stayed under the threshold for the hold time the voice can retire.
+class SilenceDetector
+{
+public:
+    void prepare(double sampleRate) noexcept
+    {
+        holdSamples = juce::jmax(1, static_cast<int>(holdTime * sampleRate));
+        reset();
+    }
+
+    void setThresholdDecibels(float thresholdDb) noexcept { threshold = juce::Decibels::decibelsToGain(thresholdDb); }
+
+    // How long the output must stay quiet - a few audio blocks at typical buffer sizes
+    void setHoldTime(double seconds) noexcept { holdTime = juce::jmax(0.0, seconds); }
+
+    void reset() noexcept { quietSamples = 0; }
+
+    // Feed the peak of the block just rendered; true once it has been quiet long enough
+    bool processBlock(float blockPeak, int numSamples) noexcept
+    {
+        if (blockPeak >= threshold)
+        {
+            quietSamples = 0;
+            return false;
+        }
+
+        quietSamples += numSamples;
+        return quietSamples >= holdSamples;
+    }
+
+private:
+    float threshold = 1.5849e-5f; // -96 dBFS
+    double holdTime = 0.02;       // seconds
+    int holdSamples = 882;
+    int quietSamples = 0;
+};
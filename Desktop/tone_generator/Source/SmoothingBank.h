@@ -0,0 +1,152 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <cstdint>
+
+// A set of linearly smoothed parameters kept side by side in arrays, replacing
+// per-sample juce::SmoothedValue::getNextValue() calls. Only parameters that are
+// actually ramping do any work: process() writes their next block of values with
+// vectorised fills, while parameters at rest are flagged constant and their buffer
+// already holds the settled value, so DSP can read either form without branching.
+template <int NumParams, int BlockSize>
+class SmoothingBank
+{
+public:
+    static_assert(NumParams > 0 && NumParams <= 32, "Ramping flags are kept in a 32-bit mask");
+
+    SmoothingBank()
+    {
+        for (int i = 0; i < BlockSize; ++i)
+            sampleIndexRamp[static_cast<size_t>(i)] = static_cast<float>(i + 1);
+
+        for (int i = 0; i < NumParams; ++i)
+            setCurrentAndTargetValue(i, 0.0f);
+    }
+
+    // Same semantics as SmoothedValue::reset(sampleRate, rampLengthInSeconds) - any ramp in flight snaps to its target
+    void reset(double sampleRate, double rampLengthInSeconds) noexcept
+    {
+        stepsToTarget = juce::jmax(1, static_cast<int>(std::floor(rampLengthInSeconds * sampleRate)));
+
+        for (int i = 0; i < NumParams; ++i)
+            setCurrentAndTargetValue(i, targets[static_cast<size_t>(i)]);
+    }
+
+    void setCurrentAndTargetValue(int index, float newValue) noexcept
+    {
+        const auto i = static_cast<size_t>(index);
+        currents[i] = targets[i] = newValue;
+        countdowns[i] = 0;
+        steps[i] = 0.0f;
+        rampingMask &= ~bit(index);
+        juce::FloatVectorOperations::fill(buffers[i].data(), newValue, BlockSize);
+    }
+
+    void setTargetValue(int index, float newValue) noexcept
+    {
+        const auto i = static_cast<size_t>(index);
+        if (newValue == targets[i])
+            return;
+
+        if (stepsToTarget <= 1)
+        {
+            setCurrentAndTargetValue(index, newValue);
+            return;
+        }
+
+        targets[i] = newValue;
+        countdowns[i] = stepsToTarget;
+        steps[i] = (newValue - currents[i]) / static_cast<float>(stepsToTarget);
+        rampingMask |= bit(index);
+    }
+
+    float getCurrentValue(int index) const noexcept { return currents[static_cast<size_t>(index)]; }
+    float getTargetValue(int index) const noexcept  { return targets[static_cast<size_t>(index)]; }
+    bool isSmoothing(int index) const noexcept      { return (rampingMask & bit(index)) != 0; }
+    bool isAnySmoothing() const noexcept            { return rampingMask != 0; }
+
+    // Renders the next numSamples (<= BlockSize) values of every ramping parameter
+    void process(int numSamples) noexcept
+    {
+        jassert(numSamples <= BlockSize);
+        constantMask = ~rampingMask;
+
+        if (rampingMask == 0 || numSamples <= 0)
+            return;
+
+        for (int index = 0; index < NumParams; ++index)
+            if ((rampingMask & bit(index)) != 0)
+                renderRamp(index, numSamples);
+    }
+
+    // True if the parameter held still for the whole of the last processed block
+    bool isConstant(int index) const noexcept { return (constantMask & bit(index)) != 0; }
+
+    // Per-sample values for the last processed block (constant parameters are pre-filled)
+    const float* getValues(int index) const noexcept { return buffers[static_cast<size_t>(index)].data(); }
+
+    // Control-rate consumers: move every ramp on by numSamples without rendering sample values
+    void advance(int numSamples) noexcept
+    {
+        if (rampingMask == 0)
+            return;
+
+        for (int index = 0; index < NumParams; ++index)
+        {
+            if ((rampingMask & bit(index)) == 0)
+                continue;
+
+            const auto i = static_cast<size_t>(index);
+            if (numSamples >= countdowns[i])
+            {
+                setCurrentAndTargetValue(index, targets[i]);
+            }
+            else
+            {
+                currents[i] += steps[i] * static_cast<float>(numSamples);
+                countdowns[i] -= numSamples;
+            }
+        }
+    }
+
+private:
+    static uint32_t bit(int index) noexcept { return 1u << static_cast<uint32_t>(index); }
+
+    void renderRamp(int index, int numSamples) noexcept
+    {
+        const auto i = static_cast<size_t>(index);
+        float* values = buffers[i].data();
+        const int rampSamples = juce::jmin(numSamples, countdowns[i]);
+
+        // current + step * (n + 1), the same sequence SmoothedValue::getNextValue() produces
+        juce::FloatVectorOperations::copyWithMultiply(values, sampleIndexRamp.data(), steps[i], rampSamples);
+        juce::FloatVectorOperations::add(values, currents[i], rampSamples);
+
+        countdowns[i] -= rampSamples;
+        if (countdowns[i] == 0)
+        {
+            // Land exactly on the target and leave the buffer settled for the blocks that follow
+            currents[i] = targets[i];
+            values[rampSamples - 1] = targets[i];
+            juce::FloatVectorOperations::fill(values + rampSamples, targets[i], BlockSize - rampSamples);
+            rampingMask &= ~bit(index);
+        }
+        else
+        {
+            currents[i] = values[rampSamples - 1];
+        }
+    }
+
+    alignas(16) std::array<std::array<float, BlockSize>, NumParams> buffers {};
+    alignas(16) std::array<float, BlockSize> sampleIndexRamp {};
+
+    std::array<float, NumParams> currents {};
+    std::array<float, NumParams> targets {};
+    std::array<float, NumParams> steps {};
+    std::array<int, NumParams> countdowns {};
+
+    uint32_t rampingMask = 0;
+    uint32_t constantMask = ~0u;
+    int stepsToTarget = 1;
+};
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <cmath>
+#include "FilterTables.h"
+
+// Low-pass biquad (RBJ cookbook, transposed direct form II) running left and
+// right together in the lanes of one SIMD register. Coefficients are only
+// recomputed when the cutoff, Q or sample rate actually change, from CutoffTable.
+class StereoBiquad
+{
+public:
+    using Vec = juce::dsp::SIMDRegister<float>;
+
+    void setSampleRate(double newSampleRate) noexcept
+    {
+        const float newInverse = static_cast<float>(1.0 / newSampleRate);
+        if (newInverse != inverseSampleRate)
+        {
+            inverseSampleRate = newInverse;
+            cutoff = -1.0f; // force a recalculation on the next setLowPass
+        }
+    }
+
+    void reset() noexcept
+    {
+        z1 = Vec::expand(0.0f);
+        z2 = Vec::expand(0.0f);
+    }
+
+    void setLowPass(float cutoffHz, float q) noexcept
+    {
+        if (cutoffHz == cutoff && q == resonance)
+            return;
+
+        cutoff = cutoffHz;
+        resonance = q;
+
+        float sinOmega = 0.0f, oneMinusCosOmega = 0.0f;
+        CutoffTable::biquadTerms(cutoffHz * inverseSampleRate, sinOmega, oneMinusCosOmega);
+
+        const float alpha = sinOmega / (2.0f * juce::jmax(0.01f, q));
+        const float a0Inverse = 1.0f / (1.0f + alpha);
+
+        b0 = Vec::expand(oneMinusCosOmega * 0.5f * a0Inverse);
+        b1 = Vec::expand(oneMinusCosOmega * a0Inverse);
+        b2 = b0;
+        a1 = Vec::expand(-2.0f * (1.0f - oneMinusCosOmega) * a0Inverse);
+        a2 = Vec::expand((1.0f - alpha) * a0Inverse);
+    }
+
+    // Filters both channels in place - left in lane 0, right in lane 1
+    void process(float* left, float* right, int numSamples) noexcept
+    {
+        alignas(Vec::SIMDRegisterSize) float lanes[Vec::SIMDNumElements] {};
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            lanes[0] = left[i];
+            lanes[1] = right[i];
+
+            const auto x = Vec::fromRawArray(lanes);
+            const auto y = b0 * x + z1;
+            z1 = b1 * x - a1 * y + z2;
+            z2 = b2 * x - a2 * y;
+
+            y.copyToRawArray(lanes);
+            left[i] = lanes[0];
+            right[i] = lanes[1];
+        }
+    }
+
+private:
+    float inverseSampleRate = 1.0f / 44100.0f;
+    float cutoff = -1.0f;
+    float resonance = -1.0f;
+
+    Vec b0 = Vec::expand(1.0f), b1 = Vec::expand(0.0f), b2 = Vec::expand(0.0f);
+    Vec a1 = Vec::expand(0.0f), a2 = Vec::expand(0.0f);
+    Vec z1 = Vec::expand(0.0f), z2 = Vec::expand(0.0f);
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Decides where a synth block is split for its MIDI. juce::Synthesiser::renderNextBlock
+// splits at every event, so dense controller data leaves the voices rendering a few
+// samples at a time. Here only events that change which notes sound (note on/off, the
+// pedals, all-notes/sound-off) split the block where they fall; everything else - CCs,
+// pitch wheel, pressure, program changes - waits for the next control boundary
+// (controlInterval samples from the block start), or for an earlier note split, and is
+// handled there in its original order. No span is shorter than minimumSubBlockSize:
+// an event closer than that to the current position is handled early, except for the
+// first split of a block when the subdivision isn't strict - the same rule
+// setMinimumRenderingSubdivisionSize() gives the base class.
+class SubBlockScheduler
+{
+public:
+    void setMinimumSubBlockSize(int numSamples, bool shouldBeStrict) noexcept
+    {
+        minimumSubBlockSize = juce::jmax(1, numSamples);
+        strict = shouldBeStrict;
+    }
+
+    void setControlInterval(int numSamples) noexcept { controlInterval = juce::jmax(1, numSamples); }
+
+    int getMinimumSubBlockSize() const noexcept { return minimumSubBlockSize; }
+    int getControlInterval() const noexcept { return controlInterval; }
+
+    // True for events that must land where they fall
+    static bool isNoteEvent(const juce::MidiMessageMetadata& event) noexcept
+    {
+        if (event.numBytes < 1)
+            return false;
+
+        const auto status = event.data[0] & 0xf0;
+        if (status == 0x80 || status == 0x90)
+            return true;
+
+        if (status != 0xb0 || event.numBytes < 2)
+            return false;
+
+        // Sustain, sostenuto and soft pedal, then the channel mode messages (all sound off,
+        // reset controllers, local control, all notes off, omni and mono/poly)
+        const auto controller = event.data[1];
+        return controller == 64 || controller == 66 || controller == 67 || controller >= 120;
+    }
+
+    // render(startSample, numSamples) for every span, handleEvent(message) for every event,
+    // in time order. Events at or after the end of the block are handled after the last span.
+    template <typename RenderFunction, typename EventFunction>
+    void process(const juce::MidiBuffer& midi, int startSample, int numSamples,
+                 RenderFunction&& render, EventFunction&& handleEvent) const
+    {
+        const int end = startSample + numSamples;
+        auto next = midi.findNextSamplePosition(startSample);
+        int position = startSample;
+        bool firstSplit = true;
+
+        while (position < end)
+        {
+            // Earliest point any remaining event asks for - events are in time order and a
+            // split is never before its event, so the scan stops at the first one past it
+            int split = end;
+            for (auto event = next; event != midi.cend() && (*event).samplePosition < split; ++event)
+            {
+                const auto& metadata = *event;
+                split = juce::jmin(split, isNoteEvent(metadata) ? juce::jmax(position, metadata.samplePosition)
+                                                               : controlBoundaryAtOrAfter(startSample, end, metadata.samplePosition));
+            }
+
+            // Everything up to the split is handled there - early when the span would be too short
+            const int handleUpTo = split;
+            const int minimumSpan = (firstSplit && ! strict) ? 1 : minimumSubBlockSize;
+            if (split < end && split - position < minimumSpan)
+                split = position;
+
+            if (split > position)
+            {
+                render(position, split - position);
+                position = split;
+                firstSplit = false;
+            }
+
+            if (position >= end)
+                break;
+
+            for (; next != midi.cend() && (*next).samplePosition <= handleUpTo; ++next)
+                handleEvent((*next).getMessage());
+        }
+
+        for (; next != midi.cend(); ++next)
+            handleEvent((*next).getMessage());
+    }
+
+private:
+    int controlBoundaryAtOrAfter(int startSample, int end, int samplePosition) const noexcept
+    {
+        const int offset = juce::jmax(0, samplePosition - startSample);
+        return juce::jmin(end, startSample + (offset + controlInterval - 1) / controlInterval * controlInterval);
+    }
+
+    int minimumSubBlockSize = 1;
+    bool strict = false;
+    int controlInterval = 32;
+};
@@ -12,6 +12,7 @@ Author:  wrattchri1
 #include "Definitions.h"
 #include "PluginProcessor.h"
 #include <cmath>
+#include <algorithm>
 
 //==============================================================================
 
@@ -26,58 +27,72 @@ void OscilVoice::startNote(int midiNoteNumber, float /*velocity*/,
         juce::SynthesiserSound* /*sound*/,
         int /*currentPitchWheelPosition*/)
 {
+        // A voice that is still sounding (retrigger or steal) is reused legato-style:
+        // phases keep running and the envelope carries on from its current level
+        const bool reuseSoundingVoice = isPlaying;
+        auto& config = state.config();
+        const float previousFreq = config.baseFrequency;
+        
         // Store the MIDI note number for this voice
-        currentMidiNote = midiNoteNumber;
+        config.midiNote = midiNoteNumber;
         
         // Configure multi-oscillator setup for lush, deep sound
-        currentFreq = static_cast<float>(juce::MidiMessage::getMidiNoteInHertz(midiNoteNumber));
+        const float currentFreq = config.baseFrequency = Tuning::inst().getNoteFrequency(midiNoteNumber, Tuning::getVoiceChannel(*this));
         
-        // Get detune amount from parameters
+        // Unison ratios for the current detune setting - only recomputed when it changes
         auto& params = ParameterHolder::inst();
-        float detuneAmount = params.parameters[VOLUME_A_PARAM].load(); // Use detune parameter
-        
-        // Enhanced detuning for bigger, lush sound
-        float baseDetune = 0.08f + (detuneAmount * 0.15f); // Wider detuning range
-        float detuneInCents = baseDetune * 100.0f; // Convert to cents
-        
-        // Create lush unison with stereo detuning
-        osc1Freq = currentFreq; // Center frequency
+        updateUnisonRatios(params.parameters[VOLUME_A_PARAM].load()); // Use detune parameter
         
-        // Left side detuning (slightly flat)
-        osc2Freq = currentFreq * std::pow(2.0f, -detuneInCents / 1200.0f);
-        osc3Freq = currentFreq * std::pow(2.0f, -detuneInCents * 0.7f / 1200.0f);
-        
-        // Right side detuning (slightly sharp)
-        osc4Freq = currentFreq * std::pow(2.0f, detuneInCents / 1200.0f);
-        osc5Freq = currentFreq * std::pow(2.0f, detuneInCents * 0.7f / 1200.0f);
-        
-        // Center oscillator with subtle detune
-        osc6Freq = currentFreq * std::pow(2.0f, detuneInCents * 0.3f / 1200.0f);
+        // Create lush unison with stereo detuning: centre, two flat, two sharp, a subtle one
+        for (int osc = 0; osc < kNumUnison; ++osc)
+            config.frequency[static_cast<size_t>(osc)] = currentFreq * unisonRatios[static_cast<size_t>(osc)];
         
         // Sub-oscillator: One octave down for deep bass foundation
-        subFreq = currentFreq * 0.5f; // One octave below
+        config.frequency[6] = currentFreq * 0.5f; // One octave below
         
-        // Reset all oscillator phases
-        osc1Phase = 0.0f;
-        osc2Phase = 0.0f;
-        osc3Phase = 0.0f;
-        osc4Phase = 0.0f;
-        osc5Phase = 0.0f;
-        osc6Phase = 0.0f;
-        subPhase = 0.0f;
+        // The filters already follow the sample rate (setCurrentPlaybackSampleRate)
+        silenceDetector.reset();
         
-        // Initialize envelope state
-        ampEnvelope = 0.01f; // Start with small value instead of 0 for immediate audio
-        noteOnTime = 0.0f;
+        if (reuseSoundingVoice)
+        {
+            // Glide from wherever the voice currently sits (including any glide in flight)
+            const float glideTime = params.parameters[GLIDE_TIME_PARAM].load();
+            glide.setMode(glideTime > 0.0f ? GlideRamp::Mode::constantTime : GlideRamp::Mode::off);
+            glide.setGlideTime(glideTime);
+            glide.start(CentsTable::ratioToCents(previousFreq / currentFreq) + glide.getCurrentOffset(), sampleRate);
+            
+            // Restart the attack from the current level rather than from silence
+            state[VoiceStateStore::noteOnTimeRow] = state[VoiceStateStore::envelopeRow] * params.parameters[VOLUME_A_PARAM].load();
+        }
+        else
+        {
+            // Reset all oscillator phases (the six unison oscillators and the sub)
+            for (int osc = 0; osc < VoiceStateStore::kNumOscillators; ++osc)
+                state.phase(osc) = 0.0f;
+            glide.reset();
+            stereoFilter.reset();
+            ladder.reset();
+            formant.reset();
+            fmFilter.reset();
+            
+            // A fresh note may change the ladder's oversampling, and start with exactly the
+            // tier's unison oscillators, without a click
+            const auto& tier = QualityController::getTier(params.qualityTier.load());
+            oversamplingAllowed = tier.allowOversampling;
+            for (int osc = 0; osc < kNumUnison; ++osc)
+                unisonGain[static_cast<size_t>(osc)] = isUnisonOscillatorKept(osc, tier.unisonOscillators) ? 1.0f : 0.0f;
+            
+            // Initialize envelope state
+            state[VoiceStateStore::envelopeRow] = 0.01f; // Start with small value instead of 0 for immediate audio
+            state[VoiceStateStore::noteOnTimeRow] = 0.0f;
+        }
         noteReleasing = false;
+        stealFadeRemaining = 0;
+        state[VoiceStateStore::stealFadeGainRow] = 1.0f;
+        filterUpdateCountdown = 0;
         
         isPlaying = true;
-        sampleRate = getSampleRate(); // Get the current sample rate from JUCE
         
-        // Debug output for voice allocation
-        DBG("=== VOICE STARTED ===");
-        DBG("MIDI Note: " << midiNoteNumber << " (" << juce::MidiMessage::getMidiNoteName(midiNoteNumber, true, true, 4) << ")");
-        DBG("Voice ID: " << juce::String::toHexString((juce::pointer_sized_int)this) << " - Dual Osc Frequencies: " << osc1Freq << " Hz + " << osc2Freq << " Hz");
         // squareWave.setSampleRate(static_cast<float>(sampleRate));
         // sawWave.setSampleRate(static_cast<float>(sampleRate));
         // noise.setSampleRate(static_cast<float>(sampleRate));
@@ -135,13 +150,51 @@ void OscilVoice::stopNote(float /*velocity*/, bool /*allowTailOff*/)
 {
         // Start envelope release phase
         noteReleasing = true;
-        noteOffTime = 0.0f; // Reset release timer
+        state[VoiceStateStore::noteOffTimeRow] = 0.0f; // Reset release timer
         // Note: don't set isPlaying = false immediately, let envelope finish release
+}
+
+void OscilVoice::setCurrentPlaybackSampleRate(double newRate)
+{
+        juce::SynthesiserVoice::setCurrentPlaybackSampleRate(newRate);
+        if (newRate <= 0.0)
+            return;
         
-        // Debug output for voice release
-        DBG("=== VOICE STOPPING ===");
-        DBG("MIDI Note: " << currentMidiNote << " (" << juce::MidiMessage::getMidiNoteName(currentMidiNote, true, true, 4) << ")");
-        DBG("Voice ID: " << juce::String::toHexString((juce::pointer_sized_int)this) << " - Starting release phase");
+        // Once per rate change rather than on every note-on
+        sampleRate = static_cast<float>(newRate);
+        silenceDetector.prepare(newRate);
+        stereoFilter.setSampleRate(newRate);
+        ladder.setSampleRate(newRate);
+        formant.setSampleRate(newRate);
+        fmFilter.setSampleRate(newRate);
+}
+
+void OscilVoice::updateUnisonRatios(float detuneParameter)
+{
+        if (detuneParameter == unisonRatiosDetune)
+            return;
+        
+        // Enhanced detuning for bigger, lush sound
+        const float baseDetune = 0.08f + (detuneParameter * 0.15f); // Wider detuning range
+        const float detuneInCents = baseDetune * 100.0f; // Convert to cents
+        
+        unisonRatios = { 1.0f,
+                         CentsTable::centsToRatio(-detuneInCents),         // left, slightly flat
+                         CentsTable::centsToRatio(-detuneInCents * 0.7f),
+                         CentsTable::centsToRatio(detuneInCents),          // right, slightly sharp
+                         CentsTable::centsToRatio(detuneInCents * 0.7f),
+                         CentsTable::centsToRatio(detuneInCents * 0.3f) }; // centre, subtle
+        unisonRatiosDetune = detuneParameter;
+}
+
+void OscilVoice::beginStealFade(int numSamples)
+{
+        if (!isPlaying || numSamples <= 0)
+            return;
+        
+        // Fade from wherever any earlier fade got to
+        stealFadeRemaining = numSamples;
+        stealFadeStep = state[VoiceStateStore::stealFadeGainRow] / static_cast<float>(numSamples);
 }
 
 void OscilVoice::processBlock(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
@@ -150,107 +203,281 @@ void OscilVoice::processBlock(juce::AudioBuffer<float>& buffer, int startSample,
             return;
         }
         
+        auto& params = ParameterHolder::inst();
+        float blockPeak = 0.0f;
+        
+        // Hot state comes out of the voice's VoiceStateStore slot once per block and goes
+        // back at the end, so the per-sample loop only touches locals
+        const auto& config = state.config();
+        const float osc1Freq = config.frequency[0], osc2Freq = config.frequency[1], osc3Freq = config.frequency[2];
+        const float osc4Freq = config.frequency[3], osc5Freq = config.frequency[4], osc6Freq = config.frequency[5];
+        const float subFreq = config.frequency[6];
+        float osc1Phase = state.phase(0), osc2Phase = state.phase(1), osc3Phase = state.phase(2);
+        float osc4Phase = state.phase(3), osc5Phase = state.phase(4), osc6Phase = state.phase(5);
+        float subPhase = state.phase(6);
+        float ampEnvelope = state[VoiceStateStore::envelopeRow];
+        float noteOnSeconds = state[VoiceStateStore::noteOnTimeRow];
+        float noteOffTime = state[VoiceStateStore::noteOffTimeRow];
+        float stealFadeGain = state[VoiceStateStore::stealFadeGainRow];
+        
+        const auto& tier = QualityController::getTier(params.qualityTier.load());
+        const float unisonFadeStep = 1.0f / (kUnisonFadeSeconds * sampleRate);
+        
+        // Each chunk is synthesised into scratch, then filtered and enveloped as a block
+        alignas(16) float leftChunk[kGlideUpdateInterval];
+        alignas(16) float rightChunk[kGlideUpdateInterval];
+        alignas(16) float gainChunk[kGlideUpdateInterval];
+        alignas(16) float modulatorChunk[kGlideUpdateInterval];
+        
         // DUAL OSCILLATOR SYNTHESIS - Using warmth parameters
-        for (int sample = 0; sample < numSamples; sample++)
+        for (int chunkStart = 0; chunkStart < numSamples && isPlaying; chunkStart += kGlideUpdateInterval)
         {
-            // Get current parameters from our warmth sliders
-            auto& params = ParameterHolder::inst();
-            float currentAttack = params.parameters[VOLUME_A_PARAM].load();
-            float currentRelease = params.parameters[VOLUME_R_PARAM].load();
+            const int chunkSize = juce::jmin(kGlideUpdateInterval, numSamples - chunkStart);
+            
+            // Phase increments, refreshed every chunk so glides ramp exponentially
+            const float glideRatio = CentsTable::centsToRatio(glide.advance(chunkSize));
+            const float ratioPerSample = glideRatio / sampleRate;
+            const float inc1 = osc1Freq * ratioPerSample, inc2 = osc2Freq * ratioPerSample, inc3 = osc3Freq * ratioPerSample;
+            const float inc4 = osc4Freq * ratioPerSample, inc5 = osc5Freq * ratioPerSample, inc6 = osc6Freq * ratioPerSample;
+            const float subInc = subFreq * ratioPerSample;
             
-            // Update envelope timers
-            if (!noteReleasing) {
-                noteOnTime += 1.0f / sampleRate;
-            } else {
-                noteOffTime += 1.0f / sampleRate;
+            // Unison oscillators the quality tier drops (and brings back) ramp over
+            // kUnisonFadeSeconds; one that is silent for the whole chunk isn't computed
+            std::array<float, kNumUnison> unisonStart, unisonStep;
+            std::array<bool, kNumUnison> unisonRunning;
+            for (int osc = 0; osc < kNumUnison; ++osc)
+            {
+                const auto k = static_cast<size_t>(osc);
+                const float target = isUnisonOscillatorKept(osc, tier.unisonOscillators) ? 1.0f : 0.0f;
+                const float end = target > unisonGain[k] ? juce::jmin(target, unisonGain[k] + unisonFadeStep * chunkSize)
+                                                         : juce::jmax(target, unisonGain[k] - unisonFadeStep * chunkSize);
+                unisonStart[k] = unisonGain[k];
+                unisonStep[k] = (end - unisonGain[k]) / static_cast<float>(chunkSize);
+                unisonRunning[k] = unisonGain[k] > 0.0f || end > 0.0f;
+                unisonGain[k] = end;
             }
             
-            // Calculate shared envelope using our warmth parameters
-            if (!noteReleasing) {
-                // Attack phase using our parameter
-                if (noteOnTime < currentAttack) {
-                    ampEnvelope = noteOnTime / currentAttack; // Linear attack
-                } else {
-                    ampEnvelope = 1.0f; // Sustain at full level
+            // Get current parameters from our warmth sliders (control rate)
+            const float currentAttack = params.parameters[VOLUME_A_PARAM].load();
+            const float currentRelease = params.parameters[VOLUME_R_PARAM].load();
+            
+            // Filter settings at the tier's control rate - every chunk at full quality
+            if (--filterUpdateCountdown < 0)
+            {
+                filterUpdateCountdown = tier.filterUpdateChunks - 1;
+                
+                // Filter cutoff from FILTER_START_PARAM - coefficients only change when it does
+                const float currentFilterCutoff = params.parameters[FILTER_START_PARAM].load();
+                filterCutoff = juce::jlimit(200.0f, 8000.0f, currentFilterCutoff * 8000.0f); // Map 0-1 to 200-8000 Hz
+                
+                const bool useLadder = params.filterModel.load() == FILTER_MODEL_LADDER;
+                const float filterFMDepth = params.filterFMAmount.load() * SVFBank::kMaxModulationDepth;
+                const bool useFilterFM = ! useLadder && filterFMDepth > 0.0f;
+                if (useLadder != usingLadder || useFilterFM != usingFilterFM)
+                {
+                    // Start the newly selected model from silence
+                    usingLadder = useLadder;
+                    usingFilterFM = useFilterFM;
+                    stereoFilter.reset();
+                    ladder.reset();
+                    fmFilter.reset();
                 }
-            } else {
-                // Release phase using our parameter
-                float releaseProgress = noteOffTime / currentRelease;
-                if (releaseProgress >= 1.0f) {
-                    ampEnvelope = 0.0f;
-                    isPlaying = false; // Stop voice when envelope is done
-                    break;
-                } else {
-                    ampEnvelope = 1.0f - releaseProgress; // Linear release
+                
+                if (usingLadder)
+                {
+                    ladder.setOversampling(params.filterOversampling.load() && oversamplingAllowed);
+                    ladder.setCutoffFrequencyHz(filterCutoff);
+                    ladder.setResonance(params.ladderResonance.load());
+                }
+                else if (usingFilterFM)
+                {
+                    // The SVF's Q matches the biquad's, so switching FM on doesn't change the base tone
+                    for (int lane = 0; lane < 2; ++lane)
+                    {
+                        fmFilter.setLaneParameters(lane, filterCutoff, filterResonance);
+                        fmFilter.setLaneModulationDepth(lane, filterFMDepth);
+                    }
+                }
+                else
+                {
+                    stereoFilter.setLowPass(filterCutoff, filterResonance);
                 }
             }
             
-            // Generate BIG, LUSH multi-oscillator sound with enhanced stereo width
+            const bool useFormant = params.formantEnabled.load();
+            if (useFormant)
+                formant.setVowel(params.formantVowel.load());
             
-            // Generate all 6 unison oscillators with different waveforms for richness
-            float osc1Output = generateOscillator(osc1Phase, osc1Freq, sampleRate, 0); // Center: Triangle-Saw blend
-            float osc2Output = generateOscillator(osc2Phase, osc2Freq, sampleRate, 1); // Left: Saw-heavy
-            float osc3Output = generateOscillator(osc3Phase, osc3Freq, sampleRate, 2); // Left: Square wave
-            float osc4Output = generateOscillator(osc4Phase, osc4Freq, sampleRate, 3); // Right: Triangle wave
-            float osc5Output = generateOscillator(osc5Phase, osc5Freq, sampleRate, 4); // Right: Sine wave
-            float osc6Output = generateOscillator(osc6Phase, osc6Freq, sampleRate, 5); // Center: Complex blend
-            
-            // Update all oscillator phases
-            osc1Phase += osc1Freq / sampleRate; if (osc1Phase >= 1.0f) osc1Phase -= 1.0f;
-            osc2Phase += osc2Freq / sampleRate; if (osc2Phase >= 1.0f) osc2Phase -= 1.0f;
-            osc3Phase += osc3Freq / sampleRate; if (osc3Phase >= 1.0f) osc3Phase -= 1.0f;
-            osc4Phase += osc4Freq / sampleRate; if (osc4Phase >= 1.0f) osc4Phase -= 1.0f;
-            osc5Phase += osc5Freq / sampleRate; if (osc5Phase >= 1.0f) osc5Phase -= 1.0f;
-            osc6Phase += osc6Freq / sampleRate; if (osc6Phase >= 1.0f) osc6Phase -= 1.0f;
-            
-            // Enhanced sub-oscillator for deep bass foundation
-            float subOutput = std::sin(subPhase * 2.0f * juce::MathConstants<float>::pi);
-            subOutput = std::tanh(subOutput * 1.2f) * 0.9f; // Stronger sub for big sound
-            subPhase += subFreq / sampleRate;
-            if (subPhase >= 1.0f) subPhase -= 1.0f;
-            
-            // Create lush stereo image with wide detuning
-            // Left channel: oscillators 1, 2, 3 + sub
-            float leftOutput = (osc1Output * 0.25f) + (osc2Output * 0.22f) + (osc3Output * 0.18f) + (subOutput * 0.12f);
-            
-            // Right channel: oscillators 1, 4, 5, 6 + sub
-            float rightOutput = (osc1Output * 0.25f) + (osc4Output * 0.22f) + (osc5Output * 0.18f) + (osc6Output * 0.15f) + (subOutput * 0.12f);
+            int rendered = 0;
+            for (; rendered < chunkSize; ++rendered)
+            {
+                // Update envelope timers
+                if (!noteReleasing) {
+                    noteOnSeconds += 1.0f / sampleRate;
+                } else {
+                    noteOffTime += 1.0f / sampleRate;
+                }
+                
+                // Calculate shared envelope using our warmth parameters
+                if (!noteReleasing) {
+                    // Attack phase using our parameter
+                    if (noteOnSeconds < currentAttack) {
+                        ampEnvelope = noteOnSeconds / currentAttack; // Linear attack
+                    } else {
+                        ampEnvelope = 1.0f; // Sustain at full level
+                    }
+                } else {
+                    // Release phase using our parameter
+                    float releaseProgress = noteOffTime / currentRelease;
+                    if (releaseProgress >= 1.0f) {
+                        ampEnvelope = 0.0f;
+                        isPlaying = false; // Stop voice when envelope is done
+                        break;
+                    } else {
+                        ampEnvelope = 1.0f - releaseProgress; // Linear release
+                    }
+                }
+                
+                // Generate BIG, LUSH multi-oscillator sound with enhanced stereo width
+                
+                // Generate all 6 unison oscillators with different waveforms for richness
+                auto unison = [&](int osc, float phase, float freq)
+                {
+                    const auto k = static_cast<size_t>(osc);
+                    return unisonRunning[k] ? generateOscillator(phase, freq, sampleRate, osc) * (unisonStart[k] + unisonStep[k] * static_cast<float>(rendered)) : 0.0f;
+                };
+                float osc1Output = unison(0, osc1Phase, osc1Freq); // Center: Triangle-Saw blend
+                float osc2Output = unison(1, osc2Phase, osc2Freq); // Left: Saw-heavy
+                float osc3Output = unison(2, osc3Phase, osc3Freq); // Left: Square wave
+                float osc4Output = unison(3, osc4Phase, osc4Freq); // Right: Triangle wave
+                // osc5 is also the filter FM source, so FM keeps it running after the tier drops it from the mix
+                const float osc5Raw = unisonRunning[4] || usingFilterFM ? generateOscillator(osc5Phase, osc5Freq, sampleRate, 4) : 0.0f;
+                float osc5Output = osc5Raw * (unisonStart[4] + unisonStep[4] * static_cast<float>(rendered)); // Right: Sine wave
+                float osc6Output = unison(5, osc6Phase, osc6Freq); // Center: Complex blend
+                
+                // Update all oscillator phases
+                osc1Phase += inc1; if (osc1Phase >= 1.0f) osc1Phase -= 1.0f;
+                osc2Phase += inc2; if (osc2Phase >= 1.0f) osc2Phase -= 1.0f;
+                osc3Phase += inc3; if (osc3Phase >= 1.0f) osc3Phase -= 1.0f;
+                osc4Phase += inc4; if (osc4Phase >= 1.0f) osc4Phase -= 1.0f;
+                osc5Phase += inc5; if (osc5Phase >= 1.0f) osc5Phase -= 1.0f;
+                osc6Phase += inc6; if (osc6Phase >= 1.0f) osc6Phase -= 1.0f;
+                
+                // Enhanced sub-oscillator for deep bass foundation
+                float subOutput = std::sin(subPhase * 2.0f * juce::MathConstants<float>::pi);
+                subOutput = std::tanh(subOutput * 1.2f) * 0.9f; // Stronger sub for big sound
+                subPhase += subInc;
+                if (subPhase >= 1.0f) subPhase -= 1.0f;
+                
+                // Create lush stereo image with wide detuning
+                // Left channel: oscillators 1, 2, 3 + sub
+                leftChunk[rendered] = (osc1Output * 0.25f) + (osc2Output * 0.22f) + (osc3Output * 0.18f) + (subOutput * 0.12f);
+                
+                // Right channel: oscillators 1, 4, 5, 6 + sub
+                rightChunk[rendered] = (osc1Output * 0.25f) + (osc4Output * 0.22f) + (osc5Output * 0.18f) + (osc6Output * 0.15f) + (subOutput * 0.12f);
+                
+                // The pure sine oscillator is the cleanest filter FM source
+                modulatorChunk[rendered] = osc5Raw;
+                
+                // Shared envelope and moderate volume
+                gainChunk[rendered] = ampEnvelope * 0.15f; // Slightly increased for lushness
+                
+                if (stealFadeRemaining > 0)
+                {
+                    gainChunk[rendered] *= stealFadeGain;
+                    stealFadeGain -= stealFadeStep;
+                    
+                    if (--stealFadeRemaining == 0)
+                    {
+                        // Faded out - the synth starts the stolen note on this voice next
+                        isPlaying = false;
+                        ++rendered;
+                        break;
+                    }
+                }
+            }
             
-            // Create stereo width and depth
-            float mixedOutput = (leftOutput + rightOutput) * 0.5f;
+            if (rendered == 0)
+                break;
             
-            // Add subtle analog-style warmth to the mixed signal
-            // Gentle compression and harmonic enhancement
-            mixedOutput = std::tanh(mixedOutput * 0.8f) * 1.1f;
+            // Vowel colour on the oscillator sum
+            if (useFormant)
+            {
+                float* channels[] = { leftChunk, rightChunk };
+                formant.process(channels, rendered);
+            }
             
-            // Apply stereo low-pass filters to soften harsh frequencies
-            // Get filter cutoff from parameters (use FILTER_START_PARAM for cutoff control)
-            float currentFilterCutoff = params.parameters[FILTER_START_PARAM].load();
-            filterCutoff = juce::jlimit(200.0f, 8000.0f, currentFilterCutoff * 8000.0f); // Map 0-1 to 200-8000 Hz
+            // Apply stereo low-pass filter to soften harsh frequencies (both channels in one pass)
+            if (usingLadder)
+            {
+                float* channels[] = { leftChunk, rightChunk };
+                ladder.process(channels, rendered);
+            }
+            else if (usingFilterFM)
+            {
+                const int stride = fmFilter.getLaneStride();
+                float* leftLane = fmFilter.getLaneData(0);
+                float* rightLane = fmFilter.getLaneData(1);
+                float* leftModulation = fmFilter.getModulationData(0);
+                float* rightModulation = fmFilter.getModulationData(1);
+                
+                for (int i = 0; i < rendered; ++i)
+                {
+                    leftLane[i * stride] = leftChunk[i];
+                    rightLane[i * stride] = rightChunk[i];
+                    leftModulation[i * stride] = modulatorChunk[i];
+                    rightModulation[i * stride] = modulatorChunk[i];
+                }
+                
+                fmFilter.process(rendered);
+                
+                for (int i = 0; i < rendered; ++i)
+                {
+                    leftChunk[i] = leftLane[i * stride];
+                    rightChunk[i] = rightLane[i * stride];
+                }
+            }
+            else
+            {
+                stereoFilter.process(leftChunk, rightChunk, rendered);
+            }
             
-            // Apply separate stereo filters for wider soundstage
-            float filteredLeft = applyStereoLowPassFilter(leftOutput, true);
-            float filteredRight = applyStereoLowPassFilter(rightOutput, false);
+            juce::FloatVectorOperations::multiply(leftChunk, gainChunk, rendered);
+            juce::FloatVectorOperations::multiply(rightChunk, gainChunk, rendered);
             
-            // Apply shared envelope and moderate volume
-            float leftFinal = filteredLeft * ampEnvelope * 0.15f; // Slightly increased for lushness
-            float rightFinal = filteredRight * ampEnvelope * 0.15f;
+            const auto leftRange = juce::FloatVectorOperations::findMinAndMax(leftChunk, rendered);
+            const auto rightRange = juce::FloatVectorOperations::findMinAndMax(rightChunk, rendered);
+            blockPeak = juce::jmax(blockPeak, leftRange.getEnd(), -leftRange.getStart(), juce::jmax(rightRange.getEnd(), -rightRange.getStart()));
             
             // Output to stereo channels with proper positioning
             if (buffer.getNumChannels() >= 2)
             {
-                // Stereo output with spatial positioning
-                buffer.addSample(0, startSample + sample, leftFinal);  // Left channel
-                buffer.addSample(1, startSample + sample, rightFinal); // Right channel
+                buffer.addFrom(0, startSample + chunkStart, leftChunk, rendered);  // Left channel
+                buffer.addFrom(1, startSample + chunkStart, rightChunk, rendered); // Right channel
             }
             else
             {
                 // Mono fallback - mix both channels
-                float monoOutput = (leftFinal + rightFinal) * 0.5f;
-                buffer.addSample(0, startSample + sample, monoOutput);
+                buffer.addFrom(0, startSample + chunkStart, leftChunk, rendered, 0.5f);
+                buffer.addFrom(0, startSample + chunkStart, rightChunk, rendered, 0.5f);
             }
         }
         
+        state.phase(0) = osc1Phase; state.phase(1) = osc2Phase; state.phase(2) = osc3Phase;
+        state.phase(3) = osc4Phase; state.phase(4) = osc5Phase; state.phase(5) = osc6Phase;
+        state.phase(6) = subPhase;
+        state[VoiceStateStore::envelopeRow] = ampEnvelope;
+        state[VoiceStateStore::noteOnTimeRow] = noteOnSeconds;
+        state[VoiceStateStore::noteOffTimeRow] = noteOffTime;
+        state[VoiceStateStore::stealFadeGainRow] = stealFadeGain;
+        
+        // Free the voice as soon as the release is inaudible rather than waiting for it to end exactly
+        if (isPlaying && noteReleasing && silenceDetector.processBlock(blockPeak, numSamples))
+            isPlaying = false;
+        
+        if (!isPlaying)
+            clearCurrentNote();
+        
         /* Original loop disabled for testing
         for (int sample = 0; sample < numSamples; sample++)
         {
@@ -428,77 +655,430 @@ float OscilVoice::generateOscillator(float phase, float freq, float sampleRate,
     return output;
 }
 
-// Simple 2-pole low-pass filter implementation
-float OscilVoice::applyLowPassFilter(float input)
+//==============================================================================
+
+OscilSynthesiser::~OscilSynthesiser()
 {
-    // Calculate filter coefficients based on cutoff frequency and sample rate
-    float omega = 2.0f * juce::MathConstants<float>::pi * filterCutoff / sampleRate;
-    float cosOmega = std::cos(omega);
-    float sinOmega = std::sin(omega);
-    float alpha = sinOmega / (2.0f * filterResonance);
-    
-    // Calculate filter coefficients
-    float b0 = (1.0f - cosOmega) / 2.0f;
-    float b1 = 1.0f - cosOmega;
-    float b2 = (1.0f - cosOmega) / 2.0f;
-    float a0 = 1.0f + alpha;
-    float a1 = -2.0f * cosOmega;
-    float a2 = 1.0f - alpha;
-    
-    // Normalize coefficients
-    b0 /= a0;
-    b1 /= a0;
-    b2 /= a0;
-    a1 /= a0;
-    a2 /= a0;
-    
-    // Apply filter
-    float output = b0 * input + b1 * filterState1 + b2 * filterState2 - a1 * filterState1 - a2 * filterState2;
-    
-    // Update filter state
-    filterState2 = filterState1;
-    filterState1 = output;
-    
-    return output;
+	// The voices outlive stateStore (the base class owns them)
+	for (int i = 0; i < voices.size(); ++i)
+		getOscilVoice(i)->detachState();
+	for (auto* tail : tailVoices)
+		tail->detachState();
 }
 
-// Stereo low-pass filter with separate state for left/right channels
-float OscilVoice::applyStereoLowPassFilter(float input, bool isLeftChannel)
+void OscilSynthesiser::prepare(double newRate, int samplesPerBlock)
 {
-    // Calculate filter coefficients based on cutoff frequency and sample rate
-    float omega = 2.0f * juce::MathConstants<float>::pi * filterCutoff / sampleRate;
-    float cosOmega = std::cos(omega);
-    float sinOmega = std::sin(omega);
-    float alpha = sinOmega / (2.0f * filterResonance);
-    
-    // Calculate filter coefficients
-    float b0 = (1.0f - cosOmega) / 2.0f;
-    float b1 = 1.0f - cosOmega;
-    float b2 = (1.0f - cosOmega) / 2.0f;
-    float a0 = 1.0f + alpha;
-    float a1 = -2.0f * cosOmega;
-    float a2 = 1.0f - alpha;
-    
-    // Normalize coefficients
-    b0 /= a0;
-    b1 /= a0;
-    b2 /= a0;
-    a1 /= a0;
-    a2 /= a0;
-    
-    // Apply filter with separate state for left/right channels
-    float output;
-    if (isLeftChannel) {
-        output = b0 * input + b1 * leftFilterState1 + b2 * leftFilterState2 - a1 * leftFilterState1 - a2 * leftFilterState2;
-        // Update left filter state
-        leftFilterState2 = leftFilterState1;
-        leftFilterState1 = output;
-    } else {
-        output = b0 * input + b1 * rightFilterState1 + b2 * rightFilterState2 - a1 * rightFilterState1 - a2 * rightFilterState2;
-        // Update right filter state
-        rightFilterState2 = rightFilterState1;
-        rightFilterState1 = output;
-    }
-    
-    return output;
+	setCurrentPlaybackSampleRate(newRate);
+	
+	const int numWorkers = juce::jlimit(0, kMaxRenderWorkers, juce::SystemStats::getNumCpus() - 1);
+	renderPool.prepare(numWorkers, samplesPerBlock, newRate);
+	
+	const juce::ScopedLock sl(lock);
+	partBuffers.resize(static_cast<size_t>(numWorkers + 1));
+	for (auto& partBuffer : partBuffers)
+		partBuffer.setSize(2, juce::jmax(1, samplesPerBlock));
+	renderList.assign(static_cast<size_t>(voices.size()), 0);
+}
+
+void OscilSynthesiser::setCurrentPlaybackSampleRate(double newRate)
+{
+	juce::Synthesiser::setCurrentPlaybackSampleRate(newRate);
+	
+	const juce::ScopedLock sl(lock);
+	
+	allocator.prepare(voices.size());
+	pendingNotes.assign(static_cast<size_t>(voices.size()), {});
+	stealFadeSamples = juce::jmax(1, juce::roundToInt(newRate * kStealFadeSeconds));
+	
+	jassert(std::all_of(voices.begin(), voices.end(), [](auto* voice) { return dynamic_cast<OscilVoice*>(voice) != nullptr; })); // see getOscilVoice()
+	
+	while (tailVoices.size() < kNumTailVoices)
+		tailVoices.add(new OscilVoice());
+	for (auto* tail : tailVoices)
+		tail->setCurrentPlaybackSampleRate(newRate);
+	
+	// One state-store slot per voice, so every voice's phases and envelopes sit in shared
+	// rows rather than scattered over the voice objects. Steals move voices between
+	// voices and tailVoices, so everything is detached before the slots are handed out.
+	for (int i = 0; i < voices.size(); ++i)
+		getOscilVoice(i)->detachState();
+	for (auto* tail : tailVoices)
+		tail->detachState();
+	
+	if (stateStore.getNumSlots() != voices.size() + tailVoices.size())
+		stateStore.prepare(voices.size() + tailVoices.size());
+	
+	for (int i = 0; i < voices.size(); ++i)
+		getOscilVoice(i)->attachState(stateStore, i);
+	for (int i = 0; i < tailVoices.size(); ++i)
+		tailVoices.getUnchecked(i)->attachState(stateStore, voices.size() + i);
+	
+	// Voices still tailing off carry on under the new bookkeeping
+	for (int i = 0; i < voices.size(); ++i)
+		if (voices.getUnchecked(i)->isVoiceActive())
+			allocator.claim(i, voices.getUnchecked(i)->getCurrentlyPlayingNote());
+	
+	updateVoiceStates();
+}
+
+void OscilSynthesiser::renderNextBlock(juce::AudioBuffer<float>& outputAudio, const juce::MidiBuffer& inputMidi, int startSample, int numSamples)
+{
+	// Must set the sample rate before using this
+	jassert(getSampleRate() > 0.0);
+	
+	const juce::ScopedLock sl(lock);
+	const bool hasChannels = outputAudio.getNumChannels() > 0;
+	
+	scheduler.setControlInterval(kControlInterval);
+	scheduler.process(inputMidi, startSample, numSamples,
+		[&](int spanStart, int spanSamples) { if (hasChannels) renderVoices(outputAudio, spanStart, spanSamples); },
+		[&](const juce::MidiMessage& message) { handleMidiEvent(message); });
+}
+
+void OscilSynthesiser::setMinimumRenderingSubdivisionSize(int numSamples, bool shouldBeStrict) noexcept
+{
+	juce::Synthesiser::setMinimumRenderingSubdivisionSize(numSamples, shouldBeStrict);
+	scheduler.setMinimumSubBlockSize(numSamples, shouldBeStrict);
+}
+
+void OscilSynthesiser::noteOn(int midiChannel, int midiNoteNumber, float velocity)
+{
+	const juce::ScopedLock sl(lock);
+	
+	if (!isAllocatorReady())
+	{
+		juce::Synthesiser::noteOn(midiChannel, midiNoteNumber, velocity);
+		return;
+	}
+	
+	auto& params = ParameterHolder::inst();
+	
+	for (auto* sound : sounds)
+	{
+		if (!sound->appliesToNote(midiNoteNumber) || !sound->appliesToChannel(midiChannel))
+			continue;
+		
+		// Hitting a note that is still ringing (held by a pedal) releases it first, like the
+		// base class. A note still waiting out a steal fade just takes the new velocity.
+		bool retriggeredPendingNote = false;
+		for (int v = allocator.getFirstOnNote(midiNoteNumber); v != VoiceAllocator::none; v = allocator.getNextOnNote(v))
+		{
+			auto& pending = pendingNotes[static_cast<size_t>(v)];
+			auto* voice = voices.getUnchecked(v);
+			
+			if (pending.sound != nullptr)
+			{
+				if (pending.midiChannel == midiChannel)
+				{
+					pending = { sound, midiChannel, velocity, false };
+					retriggeredPendingNote = true;
+				}
+			}
+			else if (voice->getCurrentlyPlayingNote() == midiNoteNumber && voice->isPlayingChannel(midiChannel))
+			{
+				stopVoice(voice, 1.0f, true);
+				allocator.release(v);
+			}
+		}
+		
+		if (retriggeredPendingNote)
+			continue;
+		
+		// Legato: glide the most recent held voice to the new note (OscilVoice::startNote
+		// keeps a sounding voice's phases and envelope running)
+		if (params.legato.load())
+		{
+			const int legatoVoice = findLegatoVoice(midiChannel);
+			if (legatoVoice != VoiceAllocator::none)
+			{
+				allocator.reassign(legatoVoice, midiNoteNumber);
+				startVoice(voices.getUnchecked(legatoVoice), sound, midiChannel, midiNoteNumber, velocity);
+				continue;
+			}
+		}
+		
+		// The quality tier may hold polyphony below the voice count - past it new notes steal
+		const int voiceLimit = QualityController::getTier(params.qualityTier.load()).voiceLimit;
+		const bool underVoiceLimit = voiceLimit <= 0 || allocator.getNumActive() < voiceLimit;
+		
+		const int freeVoice = underVoiceLimit ? allocator.popFree() : VoiceAllocator::none;
+		if (freeVoice != VoiceAllocator::none)
+		{
+			allocator.activate(freeVoice, midiNoteNumber);
+			startVoice(voices.getUnchecked(freeVoice), sound, midiChannel, midiNoteNumber, velocity);
+			continue;
+		}
+		
+		if (!isNoteStealingEnabled())
+			continue;
+		
+		const int victim = allocator.findVictim(params.voiceStealPolicy.load(), midiNoteNumber);
+		if (victim == VoiceAllocator::none)
+			continue;
+		
+		allocator.reassign(victim, midiNoteNumber);
+		auto& pending = pendingNotes[static_cast<size_t>(victim)];
+		auto* voice = getOscilVoice(victim);
+		
+		if (pending.sound == nullptr && params.parameters[GLIDE_TIME_PARAM].load() > 0.0f)
+		{
+			// Glide on: slide the sounding voice straight into the new note
+			startVoice(voice, sound, midiChannel, midiNoteNumber, velocity);
+			continue;
+		}
+		
+		if (pending.sound == nullptr)
+		{
+			// The old note fades out on a tail voice while the new one starts here now
+			if (handOffToTailVoice(victim))
+			{
+				startVoice(voices.getUnchecked(victim), sound, midiChannel, midiNoteNumber, velocity);
+				continue;
+			}
+			
+			voice->beginStealFade(stealFadeSamples);
+		}
+		
+		pending = { sound, midiChannel, velocity, false };
+	}
+	
+	publishVoiceCounts();
+}
+
+void OscilSynthesiser::noteOff(int midiChannel, int midiNoteNumber, float velocity, bool allowTailOff)
+{
+	const juce::ScopedLock sl(lock);
+	
+	if (!isAllocatorReady())
+	{
+		juce::Synthesiser::noteOff(midiChannel, midiNoteNumber, velocity, allowTailOff);
+		return;
+	}
+	
+	// Only the voices on this note. One that hasn't started yet (waiting out a steal fade)
+	// is released the moment it does.
+	for (int v = allocator.getFirstOnNote(midiNoteNumber); v != VoiceAllocator::none; v = allocator.getNextOnNote(v))
+	{
+		if (auto& pending = pendingNotes[static_cast<size_t>(v)]; pending.sound != nullptr)
+		{
+			if (pending.midiChannel == midiChannel)
+				pending.keyReleased = true;
+		}
+		else
+		{
+			releaseKey(v, midiChannel, midiNoteNumber, velocity, allowTailOff);
+		}
+	}
+}
+
+void OscilSynthesiser::allNotesOff(int midiChannel, bool allowTailOff)
+{
+	const juce::ScopedLock sl(lock);
+	
+	// Notes waiting on a steal fade are dropped - their voices fade out and retire as usual
+	for (auto& pending : pendingNotes)
+		if (midiChannel <= 0 || pending.midiChannel == midiChannel)
+			pending = {};
+	
+	juce::Synthesiser::allNotesOff(midiChannel, allowTailOff);
+}
+
+void OscilSynthesiser::renderVoices(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples)
+{
+	if (!isAllocatorReady())
+	{
+		juce::Synthesiser::renderVoices(outputAudio, startSample, numSamples);
+		return;
+	}
+	
+	const bool canRenderInParallel = ParameterHolder::inst().parallelVoiceRendering.load()
+		&& static_cast<int>(renderList.size()) == voices.size()
+		&& outputAudio.getNumChannels() == 2;
+	renderListSize = 0;
+	
+	// Only sounding voices are visited
+	for (int v = allocator.getOldest(); v != VoiceAllocator::none; v = allocator.getNextNewer(v))
+	{
+		auto* voice = getOscilVoice(v);
+		
+		if (pendingNotes[static_cast<size_t>(v)].sound != nullptr)
+		{
+			// Run the old note out to the end of its fade, then start the stolen note
+			// sample-accurately - always here on the audio thread, as it touches the synth
+			const int fadeSamples = juce::jmin(numSamples, voice->getStealFadeRemaining());
+			voice->renderNextBlock(outputAudio, startSample, fadeSamples);
+			
+			if (voice->getStealFadeRemaining() == 0)
+				startPendingNote(v);
+			
+			if (fadeSamples < numSamples)
+				voice->renderNextBlock(outputAudio, startSample + fadeSamples, numSamples - fadeSamples);
+		}
+		else if (canRenderInParallel)
+		{
+			renderList[static_cast<size_t>(renderListSize++)] = v;
+		}
+		else
+		{
+			voice->renderNextBlock(outputAudio, startSample, numSamples);
+		}
+	}
+	
+	// Stolen notes fading out - a few ms each, and never more than kNumTailVoices of them
+	for (auto* tail : tailVoices)
+		if (tail->isVoiceActive())
+			tail->renderNextBlock(outputAudio, startSample, numSamples);
+	
+	if (renderListSize > 0)
+	{
+		const int numParts = juce::jmin(renderPool.getNumWorkers() + 1, renderListSize / kMinVoicesPerRenderPart);
+		
+		if (numParts > 1)
+		{
+			renderVoicesInParallel(outputAudio, startSample, numSamples, numParts);
+		}
+		else
+		{
+			for (int i = 0; i < renderListSize; ++i)
+				getOscilVoice(renderList[static_cast<size_t>(i)])->renderNextBlock(outputAudio, startSample, numSamples);
+		}
+	}
+	
+	updateVoiceStates();
+}
+
+void OscilSynthesiser::renderVoicesInParallel(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples, int numParts)
+{
+	const int partSize = partBuffers.front().getNumSamples();
+	
+	for (int done = 0; done < numSamples; done += partSize)
+	{
+		partNumSamples = juce::jmin(partSize, numSamples - done);
+		renderPool.run(renderPart, this, numParts);
+		
+		// Fixed summing order keeps the output deterministic
+		for (int part = 0; part < numParts; ++part)
+			for (int channel = 0; channel < 2; ++channel)
+				outputAudio.addFrom(channel, startSample + done, partBuffers[static_cast<size_t>(part)], channel, 0, partNumSamples);
+	}
+}
+
+void OscilSynthesiser::renderPart(void* context, int part, int numParts)
+{
+	// Runs on the audio thread (part 0) or a pool worker - touches only its own voices and buffer
+	auto& synth = *static_cast<OscilSynthesiser*>(context);
+	auto& partBuffer = synth.partBuffers[static_cast<size_t>(part)];
+	partBuffer.clear(0, synth.partNumSamples);
+	
+	for (int i = part; i < synth.renderListSize; i += numParts)
+		synth.getOscilVoice(synth.renderList[static_cast<size_t>(i)])->renderNextBlock(partBuffer, 0, synth.partNumSamples);
+}
+
+void OscilSynthesiser::startPendingNote(int index)
+{
+	const auto pending = pendingNotes[static_cast<size_t>(index)];
+	pendingNotes[static_cast<size_t>(index)] = {};
+	
+	const int midiNoteNumber = allocator.getNote(index);
+	startVoice(voices.getUnchecked(index), pending.sound, pending.midiChannel, midiNoteNumber, pending.velocity);
+	
+	if (pending.keyReleased)
+		releaseKey(index, pending.midiChannel, midiNoteNumber, 0.0f, true);
+}
+
+void OscilSynthesiser::releaseKey(int index, int midiChannel, int midiNoteNumber, float velocity, bool allowTailOff)
+{
+	// The base class's noteOff for one voice: the key goes up, and the voice stops unless a
+	// pedal holds it
+	auto* voice = voices.getUnchecked(index);
+	if (voice->getCurrentlyPlayingNote() != midiNoteNumber || !voice->isPlayingChannel(midiChannel))
+		return;
+	
+	auto sound = voice->getCurrentlyPlayingSound();
+	if (sound == nullptr || !sound->appliesToNote(midiNoteNumber) || !sound->appliesToChannel(midiChannel))
+		return;
+	
+	voice->setKeyDown(false);
+	
+	if (!(voice->isSustainPedalDown() || voice->isSostenutoPedalDown()))
+	{
+		stopVoice(voice, velocity, allowTailOff);
+		allocator.release(index);
+	}
+}
+
+int OscilSynthesiser::findLegatoVoice(int midiChannel) const
+{
+	// Newest voice whose key is still down on this channel - the age list runs oldest first
+	int legatoVoice = VoiceAllocator::none;
+	
+	for (int v = allocator.getOldest(); v != VoiceAllocator::none; v = allocator.getNextNewer(v))
+	{
+		const auto* voice = voices.getUnchecked(v);
+		if (pendingNotes[static_cast<size_t>(v)].sound == nullptr && voice->isVoiceActive()
+			&& voice->isKeyDown() && voice->isPlayingChannel(midiChannel))
+			legatoVoice = v;
+	}
+	
+	return legatoVoice;
+}
+
+bool OscilSynthesiser::handOffToTailVoice(int index)
+{
+	for (int t = 0; t < tailVoices.size(); ++t)
+	{
+		auto* spare = tailVoices.getUnchecked(t);
+		if (spare->isVoiceActive())
+			continue;
+		
+		// Swap the objects: the victim keeps its phases, filters and envelope and fades out
+		// among the tails, and the idle spare takes its place for the new note
+		auto* stolen = getOscilVoice(index);
+		voices.set(index, spare, false);
+		tailVoices.set(t, stolen, false);
+		stolen->beginStealFade(stealFadeSamples);
+		return true;
+	}
+	
+	return false;
+}
+
+void OscilSynthesiser::updateVoiceStates()
+{
+	// Retire voices that have gone quiet and refresh the released set and levels - one pass
+	// over the sounding voices per rendered block
+	for (int v = allocator.getOldest(); v != VoiceAllocator::none;)
+	{
+		const int next = allocator.getNextNewer(v);
+		auto* voice = getOscilVoice(v);
+		
+		if (pendingNotes[static_cast<size_t>(v)].sound == nullptr)
+		{
+			if (!voice->isVoiceActive())
+			{
+				allocator.retire(v);
+			}
+			else
+			{
+				if (voice->isPlayingButReleased())
+					allocator.release(v);
+				
+				allocator.setLevel(v, voice->getCurrentLevel());
+			}
+		}
+		
+		v = next;
+	}
+	
+	publishVoiceCounts();
+}
+
+void OscilSynthesiser::publishVoiceCounts()
+{
+	int numTails = 0;
+	for (auto* tail : tailVoices)
+		numTails += tail->isVoiceActive() ? 1 : 0;
+	
+	numActiveVoices.store(allocator.getNumActive(), std::memory_order_relaxed);
+	numActiveTailVoices.store(numTails, std::memory_order_relaxed);
 }
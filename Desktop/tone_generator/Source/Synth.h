@@ -29,6 +29,19 @@
 #endif
 
 #include "PluginProcessor.h"
+#include "PitchTables.h"
+#include "Glide.h"
+#include "Tuning.h"
+#include "SilenceDetector.h"
+#include "StereoBiquad.h"
+#include "LadderFilter.h"
+#include "FormantFilter.h"
+#include "SVFBank.h"
+#include "VoiceAllocator.h"
+#include "VoiceRenderPool.h"
+#include "VoiceStateStore.h"
+#include "QualityController.h"
+#include "SubBlockScheduler.h"
 
 class OscilSound : public juce::SynthesiserSound
 {
@@ -42,11 +55,17 @@ public:
 class OscilVoice : public juce::SynthesiserVoice
 {
 public:
-	OscilVoice() = default;
+	OscilVoice()
+	{
+		fmFilter.prepare(44100.0, 2, kGlideUpdateInterval);
+		fmFilter.setLaneEnabled(0, true);
+		fmFilter.setLaneEnabled(1, true);
+	}
 	~OscilVoice() override = default;
 	bool canPlaySound(juce::SynthesiserSound* sound) override;
 	void startNote(int midiNoteNumber, float velocity, juce::SynthesiserSound* sound, int currentPitchWheelPosition) override;
 	void stopNote(float velocity, bool allowTailOff) override;
+	void setCurrentPlaybackSampleRate(double newRate) override;
 	bool isVoiceActive() const override { return isPlaying; }
         void pitchWheelMoved(int /*newValue*/) override {}
 	void controllerMoved(int /*controllerNumber*/, int /*newValue*/) override {}
@@ -55,25 +74,35 @@ public:
 		processBlock(outputBuffer, startSample, numSamples);
 	}
 
+	// Steal handover: the current note fades to silence over numSamples, then the voice goes idle
+	void beginStealFade(int numSamples);
+	int getStealFadeRemaining() const { return isPlaying ? stealFadeRemaining : 0; }
+	
+	// Envelope level including any steal fade, for the allocator's quietest policy
+	float getCurrentLevel() const { return isPlaying ? state[VoiceStateStore::envelopeRow] * state[VoiceStateStore::stealFadeGainRow] : 0.0f; }
+	
+	// Moves the voice's phases and envelope into a slot of a synth-wide store, or back to
+	// its own one-slot store - call from prepare, never while rendering
+	void attachState(VoiceStateStore& store, int slot)
+	{
+		const auto target = store.getSlot(slot);
+		state.copyTo(target);
+		state = target;
+	}
+	void detachState() { attachState(ownState, 0); }
+
 private:
 	void processBlock(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
-	float applyLowPassFilter(float input);
-	float applyStereoLowPassFilter(float input, bool isLeftChannel);
 	float generateOscillator(float phase, float freq, float sampleRate, int oscType);
 
-	// Multi-oscillator setup for lush, deep sound
-	float currentFreq = 440.0f;
 	float sampleRate = 44100.0f;
 	bool isPlaying = false;
-	int currentMidiNote = -1; // Track which MIDI note this voice is playing
 	
-	// Enhanced unison oscillators for lush, big sound (6 oscillators with stereo detuning)
-	float osc1Phase = 0.0f, osc2Phase = 0.0f, osc3Phase = 0.0f, osc4Phase = 0.0f, osc5Phase = 0.0f, osc6Phase = 0.0f;
-	float osc1Freq = 440.0f, osc2Freq = 440.0f, osc3Freq = 440.0f, osc4Freq = 440.0f, osc5Freq = 440.0f, osc6Freq = 440.0f;
-	
-	// Sub-oscillator for deep bass foundation (1 octave down)
-	float subPhase = 0.0f;
-	float subFreq = 220.0f; // One octave below base frequency
+	// Oscillator phases (6 unison oscillators with stereo detuning plus a sub an octave
+	// down), envelope state and the note's frequencies live in a VoiceStateStore slot -
+	// the synth's shared store once attached, otherwise this voice's own
+	VoiceStateStore ownState { 1 };
+	VoiceStateStore::Slot state { ownState.getSlot(0) };
 	
 	// Envelope parameters (in seconds) - shared by all oscillators
 	float ampAttack = 0.881f;  // 881ms attack
@@ -82,23 +111,142 @@ private:
 	// Detune parameters for lush unison effect
 	float detuneAmount = 0.06f; // 6 cents for warmth
 	
-	// Envelope state - shared by both oscillators
-	float ampEnvelope = 0.0f;
-	float noteOnTime = 0.0f;
-	float noteOffTime = 0.0f;
+	// Portamento when a still-sounding voice is reused for a new note
+	GlideRamp glide;
+	static constexpr int kGlideUpdateInterval = 32; // samples between glide ratio updates
+	
+	// Retires the voice once its release has decayed below -96 dBFS
+	SilenceDetector silenceDetector;
+	
 	bool noteReleasing = false;
 	
+	// Steal fade progress (the gain itself is in the state store)
+	int stealFadeRemaining = 0;
+	float stealFadeStep = 0.0f;
+	
+	// Quality tier state (QualityController): unison gains fading towards the tier's
+	// oscillator count, the filter control-rate countdown and the oversampling latch
+	static constexpr int kNumUnison = 6;
+	static constexpr float kUnisonFadeSeconds = 0.05f;
+	std::array<float, kNumUnison> unisonGain { 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+	int filterUpdateCountdown = 0;
+	bool oversamplingAllowed = true;
+	
+	// Frequency ratios of the unison oscillators, cached for the detune setting they were
+	// computed from so note-on only multiplies
+	void updateUnisonRatios(float detuneParameter);
+	std::array<float, kNumUnison> unisonRatios {};
+	float unisonRatiosDetune = -1.0f;
+	
+	// The first count oscillators of keepOrder sound - left and right alternate so the image stays balanced
+	static bool isUnisonOscillatorKept(int osc, int count)
+	{
+		constexpr std::array<int, kNumUnison> keepOrder { 0, 1, 3, 4, 2, 5 };
+		for (int i = 0; i < juce::jlimit(1, kNumUnison, count); ++i)
+			if (keepOrder[static_cast<size_t>(i)] == osc)
+				return true;
+		return false;
+	}
+	
 	// Low-pass filter for softening harsh frequencies
 	float filterCutoff = 3000.0f; // Start with gentle cutoff
 	float filterResonance = 0.3f; // Low resonance for smooth sound
-	float filterState1 = 0.0f, filterState2 = 0.0f; // Filter state variables
-	
-	// Stereo filter state for left and right channels
-	float leftFilterState1 = 0.0f, leftFilterState2 = 0.0f;
-	float rightFilterState1 = 0.0f, rightFilterState2 = 0.0f;
+	StereoBiquad stereoFilter;    // Left/right share one SIMD register
+	LadderFilter ladder { 2 };    // Alternative resonant model (FILTER_MODEL_LADDER)
+	bool usingLadder = false;
+	FormantFilter formant { 2 };  // Optional vowel colour ahead of the filter
+	SVFBank fmFilter;             // Classic model with audio-rate cutoff FM from the sine oscillator
+	bool usingFilterFM = false;
 
 	/*VOLUME_A_PARAM, VOLUME_D_PARAM, VOLUME_R_PARAM,
 		FILTER_A_PARAM, FILTER_D_PARAM, FILTER_R_PARAM, VOLUME_S_PARAM, FILTER_S_PARAM,
 		REVERB_PARAM, DELAY_PARAM, CHORUS_PARAM, COOL_EFFECT_PARAM,
 		LFO_RATE_PARAM, LFO_AMP_PARAM, FILTER_CUTOFF_PARAM, FILTER_Q_PARAM, NUM_ALL_PARAMS*/
 };
+
+// Synth for OscilVoices with constant-time voice allocation (see VoiceAllocator): a new
+// note takes a free voice, or steals one by ParameterHolder::voiceStealPolicy. A stolen
+// voice is handed to one of a few reserved tail voices, which fades its old note out over
+// a few ms while the new note starts straight away in its place. With every tail busy the
+// old note fades out first and the new one starts on the same voice after it - and with
+// glide on the voice slides legato into the new note as before.
+// Only OscilVoices may be added - voices are cast statically.
+class OscilSynthesiser : public juce::Synthesiser
+{
+public:
+	static constexpr double kStealFadeSeconds = 0.003;
+	static constexpr int kNumTailVoices = 4;        // stolen notes fading out at once
+	static constexpr int kMaxRenderWorkers = 3;     // on top of the audio thread
+	static constexpr int kMinVoicesPerRenderPart = 2; // fewer sounding voices than this per part stay serial
+	static constexpr int kControlInterval = 32;     // controller events are applied on this grid
+	
+	~OscilSynthesiser() override;
+	
+	// Sample rate plus the parallel render pool and its per-part buffers - call from prepareToPlay
+	void prepare(double newRate, int samplesPerBlock);
+	
+	void setCurrentPlaybackSampleRate(double newRate) override;
+	void noteOn(int midiChannel, int midiNoteNumber, float velocity) override;
+	void noteOff(int midiChannel, int midiNoteNumber, float velocity, bool allowTailOff) override;
+	void allNotesOff(int midiChannel, bool allowTailOff) override;
+	
+	// Splits the block only at note events (see SubBlockScheduler) - controllers wait for
+	// the next kControlInterval boundary, so automation doesn't chop the voices' spans up
+	using juce::Synthesiser::renderNextBlock;
+	void renderNextBlock(juce::AudioBuffer<float>& outputAudio, const juce::MidiBuffer& inputMidi, int startSample, int numSamples);
+	
+	// The shortest span a note event may split off (1 = sample accurate)
+	void setMinimumRenderingSubdivisionSize(int numSamples, bool shouldBeStrict = false) noexcept;
+	
+	// Sounding voices, as of the last rendered block or note-on - safe to read from any thread.
+	// Stolen notes still fading out on tail voices aren't among them; they're counted apart.
+	int getNumActiveVoices() const { return numActiveVoices.load(std::memory_order_relaxed); }
+	int getNumActiveTailVoices() const { return numActiveTailVoices.load(std::memory_order_relaxed); }
+
+protected:
+	void renderVoices(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples) override;
+
+private:
+	// A note waiting on a voice's steal fade
+	struct PendingNote
+	{
+		juce::SynthesiserSound* sound = nullptr;
+		int midiChannel = 0;
+		float velocity = 0.0f;
+		bool keyReleased = false; // note-off arrived before the note could start
+	};
+	
+	OscilVoice* getOscilVoice(int index) const { return static_cast<OscilVoice*>(voices.getUnchecked(index)); }
+	bool isAllocatorReady() const { return allocator.getNumVoices() == voices.size(); }
+	void startPendingNote(int index);
+	void releaseKey(int index, int midiChannel, int midiNoteNumber, float velocity, bool allowTailOff);
+	bool handOffToTailVoice(int index);
+	int findLegatoVoice(int midiChannel) const;
+	void updateVoiceStates();
+	void publishVoiceCounts();
+	void renderVoicesInParallel(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples, int numParts);
+	static void renderPart(void* context, int part, int numParts);
+	
+	VoiceAllocator allocator;
+	SubBlockScheduler scheduler;
+	std::vector<PendingNote> pendingNotes; // one per voice
+	int stealFadeSamples = 132;
+	std::atomic<int> numActiveVoices { 0 }, numActiveTailVoices { 0 };
+	
+	// Hot per-voice state for every voice and tail voice (attached in setCurrentPlaybackSampleRate).
+	// A slot belongs to a voice object, so it moves with it between voices and tailVoices.
+	VoiceStateStore stateStore;
+	
+	// Spare voices outside the allocator's view: idle, or fading out a stolen note. A steal
+	// swaps an idle one with the victim in voices - no copying, no allocation.
+	juce::OwnedArray<OscilVoice> tailVoices;
+	
+	// Optional parallel rendering (ParameterHolder::parallelVoiceRendering): the voices in
+	// renderList are dealt round-robin to the parts, each part renders into its own stereo
+	// buffer, and the buffers are summed in part order so the output doesn't depend on timing
+	VoiceRenderPool renderPool;
+	std::vector<juce::AudioBuffer<float>> partBuffers;
+	std::vector<int> renderList;
+	int renderListSize = 0;
+	int partNumSamples = 0;
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+
+// Hands whole values from one writer to one reader without locks or allocation. The
+// writer fills getWriteBuffer() and publishes it; the reader calls update() whenever it
+// wants the newest published value and reads it through read(). Three buffers mean
+// neither side ever waits: the spare one in the middle is swapped atomically, tagged
+// with a bit that says whether it holds something the reader hasn't taken yet.
+// Intermediate values may be skipped if the writer publishes faster than the reader
+// updates - read() always ends up at the latest.
+template <typename T>
+class TripleBuffer
+{
+public:
+    // Writer side
+    T& getWriteBuffer() noexcept { return buffers[static_cast<size_t>(writeIndex)]; }
+
+    void publish() noexcept
+    {
+        writeIndex = middle.exchange(writeIndex | freshBit, std::memory_order_acq_rel) & indexMask;
+    }
+
+    // Reader side: true if a newer value was picked up
+    bool update() noexcept
+    {
+        if ((middle.load(std::memory_order_relaxed) & freshBit) == 0)
+            return false;
+
+        readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & indexMask;
+        return true;
+    }
+
+    const T& read() const noexcept { return buffers[static_cast<size_t>(readIndex)]; }
+
+private:
+    static constexpr int indexMask = 3;
+    static constexpr int freshBit = 4;
+
+    std::array<T, 3> buffers {};
+    int writeIndex = 0;
+    int readIndex = 1;
+    std::atomic<int> middle { 2 };
+};
@@ -0,0 +1,278 @@
+#include "Tuning.h"
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    // Parsed contents of a Scala .scl file: degrees 1..n in cents, the last one is the period
+    struct ScalaScale
+    {
+        juce::String description;
+        std::vector<double> cents;
+    };
+
+    // Parsed contents of a Scala .kbm keyboard mapping
+    struct KeyboardMapping
+    {
+        int mapSize = 0;            // 0 = linear mapping, one key per degree
+        int firstNote = 0;
+        int lastNote = 127;
+        int middleNote = 60;        // key that plays degree 0
+        int referenceNote = 60;
+        double referenceFrequency = 261.6255653; // middle C at A440, Scala's default
+        int octaveDegree = 0;       // 0 = use the scale's own period
+        std::vector<int> mapping;   // -1 = unmapped key
+    };
+
+    // Non-comment lines; Scala uses '!' for comments
+    juce::StringArray getScalaLines(const juce::String& text)
+    {
+        juce::StringArray lines;
+        for (const auto& line : juce::StringArray::fromLines(text))
+            if (! line.trimStart().startsWithChar('!'))
+                lines.add(line);
+        return lines;
+    }
+
+    juce::String firstToken(const juce::String& line)
+    {
+        return line.trim().upToFirstOccurrenceOf(" ", false, false)
+                          .upToFirstOccurrenceOf("\t", false, false);
+    }
+
+    // A pitch line is cents if it contains a '.', otherwise a ratio like 3/2 or a plain integer
+    bool parseScalaPitch(const juce::String& token, double& cents)
+    {
+        if (token.containsChar('.'))
+        {
+            cents = token.getDoubleValue();
+            return true;
+        }
+
+        const double numerator = token.upToFirstOccurrenceOf("/", false, false).getDoubleValue();
+        const double denominator = token.containsChar('/')
+                                 ? token.fromFirstOccurrenceOf("/", false, false).getDoubleValue()
+                                 : 1.0;
+
+        if (numerator <= 0.0 || denominator <= 0.0)
+            return false;
+
+        cents = 1200.0 * std::log2(numerator / denominator);
+        return true;
+    }
+
+    juce::Result parseScl(const juce::String& text, ScalaScale& scale)
+    {
+        const auto lines = getScalaLines(text);
+        if (lines.size() < 2)
+            return juce::Result::fail("Scala file is missing its description or note count");
+
+        scale.description = lines[0].trim();
+
+        const int noteCount = firstToken(lines[1]).getIntValue();
+        if (noteCount <= 0 || noteCount > 1024)
+            return juce::Result::fail("Scala file has an invalid note count");
+
+        scale.cents.clear();
+        for (int i = 2; i < lines.size() && static_cast<int>(scale.cents.size()) < noteCount; ++i)
+        {
+            const auto token = firstToken(lines[i]);
+            if (token.isEmpty())
+                continue;
+
+            double cents = 0.0;
+            if (! parseScalaPitch(token, cents))
+                return juce::Result::fail("Scala file has an invalid pitch: " + token);
+
+            scale.cents.push_back(cents);
+        }
+
+        if (static_cast<int>(scale.cents.size()) != noteCount)
+            return juce::Result::fail("Scala file lists fewer pitches than its note count");
+
+        if (scale.cents.back() <= 0.0)
+            return juce::Result::fail("Scala file has a non-positive period");
+
+        return juce::Result::ok();
+    }
+
+    juce::Result parseKbm(const juce::String& text, KeyboardMapping& kbm)
+    {
+        juce::StringArray fields;
+        for (const auto& line : getScalaLines(text))
+            if (line.trim().isNotEmpty())
+                fields.add(firstToken(line));
+
+        if (fields.size() < 7)
+            return juce::Result::fail("Keyboard mapping file is missing header fields");
+
+        kbm.mapSize = fields[0].getIntValue();
+        kbm.firstNote = juce::jlimit(0, 127, fields[1].getIntValue());
+        kbm.lastNote = juce::jlimit(0, 127, fields[2].getIntValue());
+        kbm.middleNote = fields[3].getIntValue();
+        kbm.referenceNote = fields[4].getIntValue();
+        kbm.referenceFrequency = fields[5].getDoubleValue();
+        kbm.octaveDegree = fields[6].getIntValue();
+
+        if (kbm.mapSize < 0 || kbm.mapSize > 1024 || kbm.referenceFrequency <= 0.0)
+            return juce::Result::fail("Keyboard mapping file has an invalid header");
+
+        // Missing trailing entries count as unmapped
+        kbm.mapping.assign(static_cast<size_t>(kbm.mapSize), -1);
+        for (int i = 0; i < kbm.mapSize && 7 + i < fields.size(); ++i)
+            if (! fields[7 + i].equalsIgnoreCase("x"))
+                kbm.mapping[static_cast<size_t>(i)] = fields[7 + i].getIntValue();
+
+        return juce::Result::ok();
+    }
+
+    int floorDiv(int value, int divisor)
+    {
+        const int quotient = value / divisor;
+        return (value % divisor != 0 && (value < 0) != (divisor < 0)) ? quotient - 1 : quotient;
+    }
+
+    // Cents above degree 0 for any degree, wrapping by the scale's period
+    double degreeToCents(const ScalaScale& scale, int degree)
+    {
+        const int size = static_cast<int>(scale.cents.size());
+        const int periods = floorDiv(degree, size);
+        const int step = degree - periods * size;
+        const double stepCents = step == 0 ? 0.0 : scale.cents[static_cast<size_t>(step - 1)];
+        return periods * scale.cents.back() + stepCents;
+    }
+
+    // Cents above the middle note for a key, false if the key is unmapped
+    bool keyToCents(const ScalaScale& scale, const KeyboardMapping& kbm, int note, double& cents)
+    {
+        const int offset = note - kbm.middleNote;
+        if (kbm.mapSize == 0)
+        {
+            cents = degreeToCents(scale, offset);
+            return true;
+        }
+
+        const int repeats = floorDiv(offset, kbm.mapSize);
+        const int degree = kbm.mapping[static_cast<size_t>(offset - repeats * kbm.mapSize)];
+        if (degree < 0)
+            return false;
+
+        const int octaveDegree = kbm.octaveDegree > 0 ? kbm.octaveDegree : static_cast<int>(scale.cents.size());
+        cents = repeats * degreeToCents(scale, octaveDegree) + degreeToCents(scale, degree);
+        return true;
+    }
+
+    void fillEqualTemperament(std::array<float, TuningTable::kNumNotes>& frequencies, double referenceFrequency, int referenceNote)
+    {
+        for (int note = 0; note < TuningTable::kNumNotes; ++note)
+            frequencies[static_cast<size_t>(note)] = static_cast<float>(referenceFrequency * std::pow(2.0, (note - referenceNote) / 12.0));
+    }
+}
+
+Tuning::Tuning()
+{
+    CentsTable::prepare();
+
+    for (auto& table : tables)
+        for (auto& channel : table.frequencies)
+            fillEqualTemperament(channel, 440.0, 69);
+
+    description = "12-TET, A4 = 440 Hz";
+}
+
+TuningTable& Tuning::beginEdit()
+{
+    // The slot after the active one was last published two swaps ago, so no reader is in it.
+    // Start from the current tuning so per-channel edits leave the other channels alone.
+    const int active = activeTable.load(std::memory_order_relaxed);
+    auto& edited = tables[static_cast<size_t>((active + 1) % 3)];
+    edited = tables[static_cast<size_t>(active)];
+    return edited;
+}
+
+void Tuning::publish(TuningTable& edited)
+{
+    activeTable.store(static_cast<int>(&edited - tables.data()), std::memory_order_release);
+}
+
+void Tuning::setEqualTemperament(double referenceFrequency, int referenceNote)
+{
+    const juce::ScopedLock sl(writeLock);
+
+    auto& edited = beginEdit();
+    for (auto& channel : edited.frequencies)
+        fillEqualTemperament(channel, referenceFrequency, referenceNote);
+    publish(edited);
+
+    description = "12-TET, note " + juce::String(referenceNote) + " = " + juce::String(referenceFrequency, 2) + " Hz";
+}
+
+juce::Result Tuning::loadScala(const juce::File& sclFile, const juce::File& kbmFile)
+{
+    if (! sclFile.existsAsFile())
+        return juce::Result::fail("Scala file not found: " + sclFile.getFullPathName());
+
+    const juce::String kbmText = kbmFile.existsAsFile() ? kbmFile.loadFileAsString() : juce::String();
+    return loadScalaFromText(sclFile.loadFileAsString(), kbmText);
+}
+
+juce::Result Tuning::loadScalaFromText(const juce::String& sclText, const juce::String& kbmText)
+{
+    ScalaScale scale;
+    auto result = parseScl(sclText, scale);
+    if (result.failed())
+        return result;
+
+    KeyboardMapping kbm;
+    if (kbmText.isNotEmpty())
+    {
+        result = parseKbm(kbmText, kbm);
+        if (result.failed())
+            return result;
+    }
+
+    double referenceCents = 0.0;
+    if (! keyToCents(scale, kbm, kbm.referenceNote, referenceCents))
+        return juce::Result::fail("Keyboard mapping leaves the reference note unmapped");
+
+    // Keys outside the mapped range (or marked 'x') fall back to 12-TET around the reference
+    std::array<float, TuningTable::kNumNotes> frequencies;
+    fillEqualTemperament(frequencies, kbm.referenceFrequency, kbm.referenceNote);
+
+    for (int note = kbm.firstNote; note <= kbm.lastNote; ++note)
+    {
+        double cents = 0.0;
+        if (keyToCents(scale, kbm, note, cents))
+            frequencies[static_cast<size_t>(note)] = static_cast<float>(kbm.referenceFrequency * std::pow(2.0, (cents - referenceCents) / 1200.0));
+    }
+
+    const juce::ScopedLock sl(writeLock);
+
+    auto& edited = beginEdit();
+    for (auto& channel : edited.frequencies)
+        channel = frequencies;
+    publish(edited);
+
+    description = scale.description.isNotEmpty() ? scale.description : juce::String("Scala tuning");
+    DBG("Loaded tuning: " << description << " (" << static_cast<int>(scale.cents.size()) << " notes)");
+
+    return juce::Result::ok();
+}
+
+void Tuning::setChannelFrequencies(int midiChannel, const std::array<float, TuningTable::kNumNotes>& frequencies)
+{
+    if (midiChannel < 1 || midiChannel > TuningTable::kNumChannels)
+        return;
+
+    const juce::ScopedLock sl(writeLock);
+
+    auto& edited = beginEdit();
+    edited.frequencies[static_cast<size_t>(midiChannel - 1)] = frequencies;
+    publish(edited);
+}
+
+juce::String Tuning::getDescription() const
+{
+    const juce::ScopedLock sl(writeLock);
+    return description;
+}
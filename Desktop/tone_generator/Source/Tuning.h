@@ -0,0 +1,71 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include "PitchTables.h"
+
+// Frequency for every MIDI note on every channel (MTS-ESP style 128 x 16 layout)
+struct TuningTable
+{
+    static constexpr int kNumNotes = 128;
+    static constexpr int kNumChannels = 16;
+
+    std::array<std::array<float, kNumNotes>, kNumChannels> frequencies;
+};
+
+// Global tuning shared by all voices. Note-on becomes a table lookup; the
+// message thread builds a new table off to the side and publishes it with a
+// single atomic index swap, so the audio thread never sees a half-written table.
+class Tuning
+{
+private:
+    Tuning();
+
+public:
+    static Tuning& inst()
+    {
+        static Tuning tuning;
+        return tuning;
+    }
+
+    // Audio thread - channel is 1-16 as in juce::Synthesiser
+    float getNoteFrequency(int midiNoteNumber, int midiChannel = 1) const noexcept
+    {
+        const auto& table = tables[static_cast<size_t>(activeTable.load(std::memory_order_acquire))];
+        const int channel = juce::jlimit(1, TuningTable::kNumChannels, midiChannel) - 1;
+        const int note = juce::jlimit(0, TuningTable::kNumNotes - 1, midiNoteNumber);
+        return table.frequencies[static_cast<size_t>(channel)][static_cast<size_t>(note)];
+    }
+
+    // Works out which channel a voice is on (SynthesiserVoice doesn't expose it directly)
+    static int getVoiceChannel(const juce::SynthesiserVoice& voice) noexcept
+    {
+        for (int channel = 1; channel <= TuningTable::kNumChannels; ++channel)
+            if (voice.isPlayingChannel(channel))
+                return channel;
+        return 1;
+    }
+
+    static float centsToRatio(float cents) noexcept { return CentsTable::centsToRatio(cents); }
+
+    // Message thread
+    void setEqualTemperament(double referenceFrequency = 440.0, int referenceNote = 69);
+    juce::Result loadScala(const juce::File& sclFile, const juce::File& kbmFile = {});
+    juce::Result loadScalaFromText(const juce::String& sclText, const juce::String& kbmText = {});
+    void setChannelFrequencies(int midiChannel, const std::array<float, TuningTable::kNumNotes>& frequencies);
+    juce::String getDescription() const;
+
+private:
+    // Three slots: the active table, the one a reader may have just left, and one to write
+    std::array<TuningTable, 3> tables;
+    std::atomic<int> activeTable { 0 };
+
+    juce::CriticalSection writeLock;
+    juce::String description;
+
+    TuningTable& beginEdit();
+    void publish(TuningTable& edited);
+
+    JUCE_DECLARE_NON_COPYABLE(Tuning)
+};
@@ -0,0 +1,291 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Constant-time voice bookkeeping for a polyphonic synth. Voices are plain indices into
+// the synth's voice array and live in intrusive index lists, so nothing is allocated
+// or scanned after prepare():
+//  - a free stack
+//  - every sounding voice in start order (oldest at the head)
+//  - released voices in release order
+//  - one list per MIDI note
+//  - level buckets, one per 6 dB, with a bitmask so the quietest non-empty bucket is
+//    a single bit scan away
+// The owner calls activate/release/retire as voices change state and setLevel once per
+// block; none of it is thread safe, so keep every call under the synth's lock.
+class VoiceAllocator
+{
+public:
+    enum class StealPolicy { oldest, quietest, sameNote, releasedFirst, numPolicies };
+
+    static constexpr int none = -1;
+    static constexpr int kNumNotes = 128;
+    static constexpr int kNumLevelBuckets = 32; // 6 dB each, bucket 0 = silent
+
+    // Allocates the lists - call from prepare, never from the audio thread
+    void prepare(int numVoicesToUse)
+    {
+        numVoices = juce::jmax(0, numVoicesToUse);
+        const auto size = static_cast<size_t>(numVoices);
+
+        freeStack.resize(size);
+        ageLinks.resize(size);
+        releaseLinks.resize(size);
+        noteLinks.resize(size);
+        levelLinks.resize(size);
+        voiceState.resize(size);
+        reset();
+    }
+
+    // Every voice back on the free stack
+    void reset() noexcept
+    {
+        freeCount = numVoices;
+        for (int i = 0; i < numVoices; ++i)
+            freeStack[static_cast<size_t>(i)] = numVoices - 1 - i; // voice 0 is handed out first
+
+        for (auto& state : voiceState)
+            state = {};
+
+        ageList = releaseList = {};
+        noteLists.fill({});
+        levelLists.fill({});
+        levelMask = 0;
+        numActive = 0;
+    }
+
+    int getNumVoices() const noexcept { return numVoices; }
+    int getNumActive() const noexcept { return numActive; }
+    bool hasFreeVoice() const noexcept { return freeCount > 0; }
+
+    bool isActive(int voice) const noexcept { return state(voice).active; }
+    bool isReleased(int voice) const noexcept { return state(voice).released; }
+    int getNote(int voice) const noexcept { return state(voice).note; }
+
+    // Oldest-first walk over the sounding voices: for (v = getOldest(); v != none; v = getNextNewer(v))
+    int getOldest() const noexcept { return ageList.head; }
+    int getNextNewer(int voice) const noexcept { return ageLinks[static_cast<size_t>(voice)].next; }
+
+    // Walk over the voices holding one note
+    int getFirstOnNote(int note) const noexcept { return noteLists[static_cast<size_t>(note & (kNumNotes - 1))].head; }
+    int getNextOnNote(int voice) const noexcept { return noteLinks[static_cast<size_t>(voice)].next; }
+
+    // Pops a free voice, or none when every voice is sounding
+    int popFree() noexcept
+    {
+        return freeCount > 0 ? freeStack[static_cast<size_t>(--freeCount)] : none;
+    }
+
+    // Takes one particular voice off the free stack and activates it - for adopting voices
+    // that were already sounding when the allocator was prepared (linear, so not for the audio thread)
+    void claim(int voice, int note) noexcept
+    {
+        for (int i = 0; i < freeCount; ++i)
+        {
+            if (freeStack[static_cast<size_t>(i)] == voice)
+            {
+                std::swap(freeStack[static_cast<size_t>(i)], freeStack[static_cast<size_t>(freeCount - 1)]);
+                --freeCount;
+                activate(voice, note);
+                return;
+            }
+        }
+    }
+
+    // Starts tracking a voice for a note - it becomes the newest and, until its level is
+    // reported, the loudest
+    void activate(int voice, int note) noexcept
+    {
+        jassert(! isActive(voice));
+
+        auto& s = voiceState[static_cast<size_t>(voice)];
+        s.active = true;
+        s.released = false;
+        s.note = note & (kNumNotes - 1);
+        s.levelBucket = kNumLevelBuckets - 1;
+
+        pushBack(ageList, ageLinks, voice);
+        pushBack(noteLists[static_cast<size_t>(s.note)], noteLinks, voice);
+        pushBack(levelLists[static_cast<size_t>(s.levelBucket)], levelLinks, voice);
+        levelMask |= bucketBit(s.levelBucket);
+        ++numActive;
+    }
+
+    // The key went up - the voice is tailing off
+    void release(int voice) noexcept
+    {
+        auto& s = voiceState[static_cast<size_t>(voice)];
+        if (! s.active || s.released)
+            return;
+
+        s.released = true;
+        pushBack(releaseList, releaseLinks, voice);
+    }
+
+    // The voice fell silent (or is being handed to another note) - back to the free stack
+    void retire(int voice) noexcept
+    {
+        if (! isActive(voice))
+            return;
+
+        unlink(voice);
+        freeStack[static_cast<size_t>(freeCount++)] = voice;
+    }
+
+    // Moves a sounding voice straight to a new note without it passing through the free stack
+    void reassign(int voice, int note) noexcept
+    {
+        unlink(voice);
+        activate(voice, note);
+    }
+
+    // Current output level (linear) for the quietest policy - once per block is plenty
+    void setLevel(int voice, float level) noexcept
+    {
+        auto& s = voiceState[static_cast<size_t>(voice)];
+        if (! s.active)
+            return;
+
+        const int bucket = levelToBucket(level);
+        if (bucket == s.levelBucket)
+            return;
+
+        removeFromLevelBucket(voice);
+        s.levelBucket = bucket;
+        pushBack(levelLists[static_cast<size_t>(bucket)], levelLinks, voice);
+        levelMask |= bucketBit(bucket);
+    }
+
+    // The voice to take over for a new note when none are free. sameNote and
+    // releasedFirst fall back to the oldest voice when they have nothing to offer.
+    int findVictim(StealPolicy policy, int note) const noexcept
+    {
+        switch (policy)
+        {
+            case StealPolicy::quietest:
+                if (levelMask != 0)
+                    return levelLists[static_cast<size_t>(lowestBucket())].head;
+                break;
+
+            case StealPolicy::sameNote:
+                if (const int voice = getFirstOnNote(note); voice != none)
+                    return voice;
+                break;
+
+            case StealPolicy::releasedFirst:
+                if (releaseList.head != none)
+                    return releaseList.head;
+                break;
+
+            case StealPolicy::oldest:
+            case StealPolicy::numPolicies:
+                break;
+        }
+
+        return ageList.head;
+    }
+
+private:
+    struct Links { int previous = none, next = none; };
+    struct List { int head = none, tail = none; };
+
+    struct VoiceState
+    {
+        bool active = false;
+        bool released = false;
+        int note = 0;
+        int levelBucket = 0;
+    };
+
+    const VoiceState& state(int voice) const noexcept { return voiceState[static_cast<size_t>(voice)]; }
+
+    static uint32_t bucketBit(int bucket) noexcept { return uint32_t { 1 } << bucket; }
+
+    // Index of the quietest non-empty bucket: isolate the lowest set bit, then find it
+    int lowestBucket() const noexcept { return juce::findHighestSetBit(levelMask & (~levelMask + 1u)); }
+
+    // 6 dB per bucket from the float exponent: bucket 31 covers full scale, 0 is -186 dB and below
+    static int levelToBucket(float level) noexcept
+    {
+        if (! (level > 0.0f))
+            return 0;
+
+        return juce::jlimit(0, kNumLevelBuckets - 1, std::ilogb(level) + kNumLevelBuckets);
+    }
+
+    static void pushBack(List& list, std::vector<Links>& links, int voice) noexcept
+    {
+        auto& link = links[static_cast<size_t>(voice)];
+        link.previous = list.tail;
+        link.next = none;
+
+        if (list.tail != none)
+            links[static_cast<size_t>(list.tail)].next = voice;
+        else
+            list.head = voice;
+
+        list.tail = voice;
+    }
+
+    static void remove(List& list, std::vector<Links>& links, int voice) noexcept
+    {
+        auto& link = links[static_cast<size_t>(voice)];
+
+        if (link.previous != none)
+            links[static_cast<size_t>(link.previous)].next = link.next;
+        else
+            list.head = link.next;
+
+        if (link.next != none)
+            links[static_cast<size_t>(link.next)].previous = link.previous;
+        else
+            list.tail = link.previous;
+
+        link = {};
+    }
+
+    void removeFromLevelBucket(int voice) noexcept
+    {
+        const int bucket = state(voice).levelBucket;
+        auto& list = levelLists[static_cast<size_t>(bucket)];
+        remove(list, levelLinks, voice);
+
+        if (list.head == none)
+            levelMask &= ~bucketBit(bucket);
+    }
+
+    void unlink(int voice) noexcept
+    {
+        auto& s = voiceState[static_cast<size_t>(voice)];
+        if (! s.active)
+            return;
+
+        remove(ageList, ageLinks, voice);
+        remove(noteLists[static_cast<size_t>(s.note)], noteLinks, voice);
+        removeFromLevelBucket(voice);
+
+        if (s.released)
+            remove(releaseList, releaseLinks, voice);
+
+        s = {};
+        --numActive;
+    }
+
+    int numVoices = 0;
+    int numActive = 0;
+
+    std::vector<int> freeStack;
+    int freeCount = 0;
+
+    std::vector<VoiceState> voiceState;
+    std::vector<Links> ageLinks, releaseLinks, noteLinks, levelLinks;
+
+    List ageList, releaseList;
+    std::array<List, kNumNotes> noteLists {};
+    std::array<List, kNumLevelBuckets> levelLists {};
+    uint32_t levelMask = 0;
+};
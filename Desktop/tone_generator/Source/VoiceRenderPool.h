@@ -0,0 +1,252 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#if JUCE_INTEL
+ #include <immintrin.h>
+#endif
+
+#if defined __APPLE__
+ #include <mach/mach.h>
+#elif ! defined _WIN32
+ #include <semaphore.h>
+#endif
+
+// A few pre-spawned real-time workers that split one job with the audio thread.
+// run() takes part 0 itself and posts the job only to the workers it needs, by bumping
+// each one's job counter; a worker spins on its counter for a small fraction of a block
+// period after each job (catching a second render in the same callback), then parks on a
+// kernel semaphore until the next one. Waking a parked worker is a flag exchange plus a
+// semaphore signal - no locks or allocation on the audio thread - and a worker that
+// didn't park, or isn't needed, costs nothing. Each posted worker acknowledges its part,
+// which keeps the job fields stable until nobody can still be reading them.
+class VoiceRenderPool
+{
+public:
+    static constexpr int kMaxWorkers = 7;
+    static constexpr double kSpinFractionOfBlock = 0.1;
+    static constexpr int kSpinIterations = 4096;
+
+    // part runs for part = 0 .. numParts - 1, each exactly once
+    using Task = void (*)(void* context, int part, int numParts);
+
+    ~VoiceRenderPool() { stop(); }
+
+    // Spawns the workers - call from prepare, never from the audio thread
+    void prepare(int numWorkersToUse, int samplesPerBlock, double sampleRate)
+    {
+        const double blockSeconds = samplesPerBlock / juce::jmax(1.0, sampleRate);
+        spinTicks.store(juce::Time::secondsToHighResolutionTicks(blockSeconds * kSpinFractionOfBlock), std::memory_order_relaxed);
+
+        const int wanted = juce::jlimit(0, kMaxWorkers, numWorkersToUse);
+        if (wanted == numWorkers)
+            return;
+
+        stop();
+
+        const auto options = juce::Thread::RealtimeOptions{}.withApproximateAudioProcessingTime(samplesPerBlock, sampleRate);
+
+        for (int i = 0; i < wanted; ++i)
+        {
+            workers[static_cast<size_t>(i)] = std::make_unique<Worker>(*this, i + 1);
+            auto& worker = *workers[static_cast<size_t>(i)];
+
+            // Fall back to an ordinary high-priority thread where real-time scheduling is refused
+            if (! worker.startRealtimeThread(options))
+                worker.startThread(juce::Thread::Priority::highest);
+        }
+
+        numWorkers = wanted;
+    }
+
+    void stop()
+    {
+        for (int i = 0; i < numWorkers; ++i)
+        {
+            auto& worker = *workers[static_cast<size_t>(i)];
+            worker.signalThreadShouldExit();
+            worker.wakeIfParked();
+        }
+
+        for (int i = 0; i < numWorkers; ++i)
+        {
+            workers[static_cast<size_t>(i)]->stopThread(1000);
+            workers[static_cast<size_t>(i)].reset();
+        }
+
+        numWorkers = 0;
+    }
+
+    // Workers, not counting the thread that calls run()
+    int getNumWorkers() const noexcept { return numWorkers; }
+
+    // Audio thread: runs the job across the caller and the workers and returns when every
+    // part is done. numParts is clamped to getNumWorkers() + 1.
+    void run(Task taskToRun, void* contextToUse, int numPartsToRun) noexcept
+    {
+        const int parts = juce::jlimit(1, numWorkers + 1, numPartsToRun);
+        if (parts == 1 || numWorkers == 0)
+        {
+            taskToRun(contextToUse, 0, 1);
+            return;
+        }
+
+        task = taskToRun;
+        context = contextToUse;
+        numParts = parts;
+        remaining.store(parts - 1, std::memory_order_relaxed);
+
+        // Workers 1 .. parts - 1 only; the rest stay parked. seq_cst pairs with the
+        // worker's parked store / job load, so a worker about to sleep either sees this
+        // job or is seen as parked here.
+        for (int i = 0; i < parts - 1; ++i)
+            workers[static_cast<size_t>(i)]->post();
+
+        taskToRun(contextToUse, 0, parts);
+
+        // Spin for the stragglers; yield if one of them has been preempted
+        for (int spin = 0; remaining.load(std::memory_order_acquire) != 0; ++spin)
+        {
+            if (spin < kSpinIterations)
+                pause();
+            else
+                std::this_thread::yield();
+        }
+    }
+
+private:
+    // Counting semaphore straight on the kernel's primitive: signal() is a single call
+    // that takes no user-space lock, so the audio thread can make it
+    class Semaphore
+    {
+    public:
+       #if defined __APPLE__
+        Semaphore()           { semaphore_create(mach_task_self(), &semaphore, SYNC_POLICY_FIFO, 0); }
+        ~Semaphore()          { semaphore_destroy(mach_task_self(), semaphore); }
+        void signal() noexcept { semaphore_signal(semaphore); }
+        void wait() noexcept   { while (semaphore_wait(semaphore) == KERN_ABORTED) {} }
+       #elif defined _WIN32
+        // No lock-free primitive reachable through JUCE here - an auto-reset event will do
+        void signal() noexcept { event.signal(); }
+        void wait() noexcept   { event.wait(-1); }
+       #else
+        Semaphore()           { sem_init(&semaphore, 0, 0); }
+        ~Semaphore()          { sem_destroy(&semaphore); }
+        void signal() noexcept { sem_post(&semaphore); }
+        void wait() noexcept   { while (sem_wait(&semaphore) != 0) {} } // EINTR
+       #endif
+
+    private:
+       #if defined __APPLE__
+        semaphore_t semaphore {};
+       #elif defined _WIN32
+        juce::WaitableEvent event;
+       #else
+        sem_t semaphore {};
+       #endif
+
+        JUCE_DECLARE_NON_COPYABLE(Semaphore)
+    };
+
+    class Worker : public juce::Thread
+    {
+    public:
+        Worker(VoiceRenderPool& ownerToUse, int partToRun)
+            : juce::Thread("Voice render " + juce::String(partToRun)), owner(ownerToUse), part(partToRun) {}
+
+        void run() override
+        {
+            while (! threadShouldExit())
+            {
+                if (! waitForJob())
+                    continue;
+
+                seen = jobs.load(std::memory_order_acquire);
+                owner.task(owner.context, part, owner.numParts);
+                owner.remaining.fetch_sub(1, std::memory_order_release);
+            }
+        }
+
+        // Audio thread: hands this worker its part of the job just published
+        void post() noexcept
+        {
+            jobs.fetch_add(1, std::memory_order_seq_cst);
+            wakeIfParked();
+        }
+
+        // Any thread. Whoever clears the parked flag owes the worker exactly one signal,
+        // so the semaphore never collects stale wake-ups.
+        void wakeIfParked() noexcept
+        {
+            if (parked.load(std::memory_order_seq_cst) && parked.exchange(false, std::memory_order_seq_cst))
+                wake.signal();
+        }
+
+    private:
+        // True once a job newer than the last one taken is posted
+        bool waitForJob()
+        {
+            auto hasJob = [&] { return jobs.load(std::memory_order_seq_cst) != seen; };
+
+            // Spin for kSpinFractionOfBlock of a block period in case another job follows in
+            // the same callback (the next sub-block), checking the clock every 64 pauses
+            const auto spinUntil = juce::Time::getHighResolutionTicks() + owner.spinTicks.load(std::memory_order_relaxed);
+            do
+            {
+                for (int spin = 0; spin < 64; ++spin)
+                {
+                    if (hasJob())
+                        return true;
+                    pause();
+                }
+            }
+            while (juce::Time::getHighResolutionTicks() < spinUntil && ! threadShouldExit());
+
+            // Park until run() or stop() wakes us. If a job (or exit) slipped in meanwhile,
+            // back out - unless a waker already claimed the flag, whose signal must be taken.
+            parked.store(true, std::memory_order_seq_cst);
+            if ((hasJob() || threadShouldExit()) && parked.exchange(false, std::memory_order_seq_cst))
+                return hasJob();
+
+            wake.wait();
+            return hasJob();
+        }
+
+        std::atomic<uint32_t> jobs { 0 }; // posted so far
+        std::atomic<bool> parked { false };
+        Semaphore wake;
+
+        VoiceRenderPool& owner;
+        const int part;
+        uint32_t seen = 0; // jobs taken so far
+    };
+
+    // A spin-wait hint to the core, not a trip into the scheduler
+    static void pause() noexcept
+    {
+       #if JUCE_INTEL
+        _mm_pause();
+       #elif JUCE_ARM && defined _MSC_VER
+        __yield();
+       #elif JUCE_ARM
+        __asm__ __volatile__ ("yield" ::: "memory");
+       #else
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+       #endif
+    }
+
+    std::array<std::unique_ptr<Worker>, kMaxWorkers> workers;
+    int numWorkers = 0;
+
+    // The current job - written before the workers are posted, stable until remaining reaches 0
+    Task task = nullptr;
+    void* context = nullptr;
+    int numParts = 0;
+
+    std::atomic<juce::int64> spinTicks { 0 }; // how long a worker spins after a job before parking
+    std::atomic<int> remaining { 0 };
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+
+// Per-voice oscillator and envelope state for every voice in one synth, kept apart from
+// the voice objects:
+//  - hot rows (phases and envelope state, touched every sample) as structure-of-arrays:
+//    one float per voice slot, every row starting on its own cache line and padded to a
+//    whole number of lines, so a row is ready to be read a SIMD register at a time
+//  - cold configuration (frequencies and note), only read at control rate, in a
+//    separate array
+// Voices address their state through a Slot. A voice without a synth-wide store keeps a
+// one-slot store of its own.
+class VoiceStateStore
+{
+public:
+    static constexpr int kNumOscillators = 7; // six unison oscillators plus the sub
+    static constexpr int kFloatsPerLine = 16; // 64-byte cache lines
+
+    enum HotRow
+    {
+        phaseRow,                                // kNumOscillators rows, 0..1
+        envelopeRow = phaseRow + kNumOscillators, // amplitude envelope level
+        noteOnTimeRow,                           // seconds since the attack began
+        noteOffTimeRow,                          // seconds since the release began
+        stealFadeGainRow,                        // 1 unless a steal fade is running
+        numHotRows
+    };
+
+    struct VoiceConfig
+    {
+        std::array<float, kNumOscillators> frequency {};
+        float baseFrequency = 440.0f;
+        int midiNote = -1;
+    };
+
+    class Slot
+    {
+    public:
+        Slot() = default;
+        Slot(VoiceStateStore& storeToUse, int slotIndex) : store(&storeToUse), index(slotIndex) {}
+
+        float& operator[](int row) const noexcept { return store->row(row)[index]; }
+        float& phase(int oscillator) const noexcept { return (*this)[phaseRow + oscillator]; }
+        VoiceConfig& config() const noexcept { return store->configs[static_cast<size_t>(index)]; }
+
+        // Copies everything this slot holds into another one
+        void copyTo(const Slot& other) const noexcept
+        {
+            for (int r = 0; r < numHotRows; ++r)
+                other[r] = (*this)[r];
+            other.config() = config();
+        }
+
+    private:
+        VoiceStateStore* store = nullptr;
+        int index = 0;
+    };
+
+    VoiceStateStore() = default;
+    explicit VoiceStateStore(int numSlotsToUse) { prepare(numSlotsToUse); }
+
+    // Allocates the arena - call from prepare, never from the audio thread. Any state
+    // already held is lost, so move voices out first.
+    void prepare(int numSlotsToUse)
+    {
+        numSlots = juce::jmax(1, numSlotsToUse);
+        stride = (numSlots + kFloatsPerLine - 1) / kFloatsPerLine * kFloatsPerLine;
+
+        // One spare line so the first row can be moved onto a line boundary
+        arena.calloc(static_cast<size_t>(numHotRows * stride + kFloatsPerLine));
+        const auto address = reinterpret_cast<juce::pointer_sized_uint>(arena.get());
+        const auto misalignment = static_cast<int>((address / sizeof(float)) % kFloatsPerLine);
+        rows = arena.get() + (misalignment == 0 ? 0 : kFloatsPerLine - misalignment);
+
+        configs.assign(static_cast<size_t>(numSlots), {});
+
+        for (int slot = 0; slot < numSlots; ++slot)
+            row(stealFadeGainRow)[slot] = 1.0f;
+    }
+
+    int getNumSlots() const noexcept { return numSlots; }
+    Slot getSlot(int slot) noexcept { return { *this, slot }; }
+
+    // A whole row, numSlots values long (padded to a multiple of kFloatsPerLine)
+    float* row(int rowIndex) noexcept { return rows + rowIndex * stride; }
+    const float* row(int rowIndex) const noexcept { return rows + rowIndex * stride; }
+
+private:
+    juce::HeapBlock<float> arena;
+    float* rows = nullptr;
+    int numSlots = 0;
+    int stride = 0;
+
+    std::vector<VoiceConfig> configs;
+};